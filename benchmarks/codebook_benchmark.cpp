@@ -0,0 +1,320 @@
+/**
+ * =====================================================================================
+ * Benchmarks:  DSU, SegTree, LCA, CycleDetector and ParallelCycleFinder (Google Benchmark)
+ * Description: Sweeps N over a few workloads per structure, so variants can be
+ * compared and regressions caught.
+ * * =====================================================================================
+ * * Build & Run:
+ * g++ -std=c++20 -O2 -march=native benchmarks/codebook_benchmark.cpp -lbenchmark -pthread -o codebook_benchmark
+ * ./codebook_benchmark --benchmark_filter='DSU'
+ * * Sizes sweep N = 10^3 .. 10^8 by powers of ten. The top sizes need several GB
+ * (the LCA table alone is ~11 GB at 10^8), so cap them at build time when needed:
+ * -DCODEBOOK_BENCH_MAX_N=1000000
+ * * =====================================================================================
+ * * Workloads (every benchmark is named `BM_<structure><variant>/<workload>/N`):
+ * - DSU:       random unions + finds, vs. the binomial merge order that
+ *              maximises tree height under union by size.
+ * - SegTree:   uniformly random ranges, vs. short ranges clustered around a
+ *              slowly drifting point (the cache-friendly case). Sums over
+ *              int64_t in every engine, so the comparison is like for like.
+ * - LCA:       random recursive tree (depth O(log N)), vs. a path (depth N).
+ * - FindCycle: a DAG the DFS must fully scan, vs. the same DAG with one back
+ *              edge closing a cycle at the deepest node.
+ * - GiantSCC:  ParallelCycleFinder SCCs of a ring plus N random edges (one SCC
+ *              holding every node), for 1, 2, 4 and 8 threads: the speedup of
+ *              the passes inside a single task.
+ * * =====================================================================================
+ * * Counters:
+ * - per_op:       wall time per operation (printed with an SI prefix: 12.3n = 12.3 ns).
+ * - bytes/elem:   memory held by the structure, divided by N.
+ * - misses/op:    hardware cache misses per operation, from perf_event. Omitted
+ *                 when the kernel refuses the counter (containers, paranoid > 2).
+ * * =====================================================================================
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "../data_structures/dsu.cpp"
+#include "../data_structures/segment_tree.cpp"
+#include "../data_structures/wide_segment_tree.cpp"
+#include "../data_structures/simd_segment_tree.cpp"
+#include "../graphs/lca_binary_lifting.cpp"
+#include "../graphs/lca_euler_rmq.cpp"
+#include "../graphs/unified_graph_cycle_finder.cpp"
+#include "../graphs/parallel_cycle_finder.cpp"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifndef CODEBOOK_BENCH_MAX_N
+#define CODEBOOK_BENCH_MAX_N 100000000
+#endif
+
+// Counts user-space cache misses of this thread between construction and stop()
+struct CacheMissCounter {
+    int fd = -1;
+
+    CacheMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+    ~CacheMissCounter() {
+#ifdef __linux__
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    // Returns the miss count, or -1 if perf_event is unavailable
+    long long stop() {
+        long long count = -1;
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &count, sizeof(count)) != sizeof(count)) count = -1;
+        }
+#endif
+        return count;
+    }
+};
+
+template<typename V>
+size_t bytes_of(const V& v) { return v.capacity() * sizeof(typename V::value_type); }
+
+template<typename V, typename A>
+size_t bytes_of(const std::vector<std::vector<V>, A>& v) {
+    size_t total = v.capacity() * sizeof(std::vector<V>);
+    for (const auto& row : v) total += bytes_of(row);
+    return total;
+}
+
+// Fills in the common counters once the timed loop is done
+void report(benchmark::State& state, CacheMissCounter& perf, double ops_per_iter, size_t bytes) {
+    long long misses = perf.stop();
+    double ops = ops_per_iter * (double)state.iterations();
+    state.SetItemsProcessed((int64_t)ops);
+    state.counters["per_op"] = benchmark::Counter(ops, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.counters["bytes/elem"] = (double)bytes / (double)state.range(0);
+    if (misses >= 0) state.counters["misses/op"] = (double)misses / ops;
+}
+
+// Fixed seed: every variant sees exactly the same input for a given N
+std::mt19937_64 make_rng(int64_t n) { return std::mt19937_64(0x5EED ^ (uint64_t)n); }
+
+// Queries per iteration for the structures that are built once per run
+int query_count(int n) { return std::min(n, 1 << 20); }
+
+void size_sweep(benchmark::internal::Benchmark* b) {
+    for (int64_t n = 1000; n <= CODEBOOK_BENCH_MAX_N; n *= 10) b->Arg(n);
+    b->Unit(benchmark::kMillisecond);
+}
+
+// ------------------------------------------------------------------ DSU
+
+enum Workload { Random, Adversarial };
+
+// A union sequence followed by a find from every element
+std::vector<std::pair<int, int>> dsu_unions(int n, Workload w) {
+    std::vector<std::pair<int, int>> ops;
+    if (w == Random) {
+        auto rng = make_rng(n);
+        for (int i = 0; i < n; ++i) ops.push_back({(int)(rng() % n), (int)(rng() % n)});
+    } else {
+        // Merge equal-sized sets round by round: binomial trees of height log N
+        for (int step = 1; step < n; step *= 2) {
+            for (int i = 0; i + step < n; i += 2 * step) ops.push_back({i, i + step});
+        }
+    }
+    return ops;
+}
+
+template<typename D>
+void BM_DSU(benchmark::State& state, Workload w) {
+    int n = (int)state.range(0);
+    auto unions = dsu_unions(n, w);
+    size_t bytes = 0;
+    CacheMissCounter perf;
+    for (auto _ : state) {
+        D dsu(n);
+        for (auto [a, b] : unions) dsu.union_sets(a, b);
+        for (int v = n - 1; v >= 0; --v) benchmark::DoNotOptimize(dsu.find_set(v));
+        bytes = bytes_of(dsu.parent);
+        if constexpr (requires { dsu.sz; }) bytes += bytes_of(dsu.sz);
+    }
+    report(state, perf, (double)unions.size() + n, bytes);
+}
+
+// ------------------------------------------------------------------ SegTree
+
+enum Ranges { Uniform, Clustered };
+
+std::vector<std::pair<int, int>> segtree_ranges(int n, Ranges r) {
+    auto rng = make_rng(n);
+    std::vector<std::pair<int, int>> queries(query_count(n));
+    int center = n / 2;
+    for (auto& [l, rr] : queries) {
+        if (r == Uniform) {
+            l = (int)(rng() % n), rr = (int)(rng() % n);
+            if (l > rr) std::swap(l, rr);
+        } else {
+            // Ranges of at most 64 around a point that drifts by at most 8
+            center = std::clamp(center + (int)(rng() % 17) - 8, 0, n - 1);
+            l = std::max(0, center - (int)(rng() % 32));
+            rr = std::min(n - 1, center + (int)(rng() % 32));
+        }
+    }
+    return queries;
+}
+
+template<typename Tree>
+void BM_SegTree(benchmark::State& state, Ranges r) {
+    int n = (int)state.range(0);
+    auto rng = make_rng(n);
+    std::vector<int> a(n);
+    for (int& x : a) x = (int)(rng() % 1000);
+    Tree tree(a);
+    auto queries = segtree_ranges(n, r);
+    CacheMissCounter perf;
+    for (auto _ : state) {
+        for (auto [l, rr] : queries) benchmark::DoNotOptimize(tree.query(l, rr));
+    }
+    size_t bytes = bytes_of(tree.t);
+    if constexpr (requires { tree.offset; }) bytes += bytes_of(tree.offset);
+    report(state, perf, (double)queries.size(), bytes);
+}
+
+// ------------------------------------------------------------------ LCA
+
+enum Shape { RandomTree, PathTree };
+
+template<typename Tree>
+void BM_LCA(benchmark::State& state, Shape shape) {
+    int n = (int)state.range(0);
+    auto rng = make_rng(n);
+    Tree tree(n);
+    for (int v = 2; v <= n; ++v) {
+        int parent = shape == PathTree ? v - 1 : 1 + (int)(rng() % (v - 1));
+        tree.add_edge(parent, v);
+    }
+    tree.build(1);
+    std::vector<std::pair<int, int>> queries(query_count(n));
+    for (auto& [u, v] : queries) u = 1 + (int)(rng() % n), v = 1 + (int)(rng() % n);
+    CacheMissCounter perf;
+    for (auto _ : state) {
+        for (auto [u, v] : queries) benchmark::DoNotOptimize(tree.lca(u, v));
+    }
+    size_t bytes = bytes_of(tree.adj);
+    if constexpr (requires { tree.tables; }) {
+        bytes += sizeof(int) * (tree.LOG + 1) * (n + 1); // flat depth + 'up' table
+    } else {
+        bytes += bytes_of(tree.depth) + bytes_of(tree.sparse) + bytes_of(tree.tin);
+    }
+    report(state, perf, (double)queries.size(), bytes);
+}
+
+// ------------------------------------------------------------------ CycleDetector
+
+enum Cycles { Acyclic, Cyclic };
+
+void BM_FindCycle(benchmark::State& state, Cycles c) {
+    int n = (int)state.range(0);
+    auto rng = make_rng(n);
+    // A path 1 -> 2 -> ... -> n (so the DFS goes N deep) plus N random forward edges
+    std::vector<std::pair<int, int>> edges;
+    for (int v = 1; v < n; ++v) edges.push_back({v, v + 1});
+    for (int i = 0; i < n; ++i) {
+        int u = 1 + (int)(rng() % n), v = 1 + (int)(rng() % n);
+        if (u != v) edges.push_back({std::min(u, v), std::max(u, v)});
+    }
+    if (c == Cyclic) edges.push_back({n, 1});
+    CSRGraph graph(n, edges);
+    CycleDetector detector(graph);
+    std::vector<int> cycle;
+    CacheMissCounter perf;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(detector.find_cycle(cycle));
+    }
+    size_t bytes = graph.offset.size_bytes() + graph.adj.size_bytes() + bytes_of(detector.visit) +
+                   bytes_of(detector.parent) + bytes_of(detector.dfs_stack) + bytes_of(cycle);
+    report(state, perf, (double)n + (double)edges.size(), bytes);
+}
+
+// ------------------------------------------------------------------ ParallelCycleFinder
+
+void BM_GiantSCC(benchmark::State& state, int threads) {
+    int n = (int)state.range(0);
+    auto rng = make_rng(n);
+    // The ring alone makes every node one SCC; the random edges keep BFS levels wide
+    std::vector<std::pair<int, int>> edges;
+    for (int v = 1; v <= n; ++v) edges.push_back({v, v % n + 1});
+    for (int i = 0; i < n; ++i) edges.push_back({1 + (int)(rng() % n), 1 + (int)(rng() % n)});
+    CSRGraph graph(n, edges);
+    CacheMissCounter perf;
+    for (auto _ : state) {
+        ParallelCycleFinder finder(graph, false, threads);
+        benchmark::DoNotOptimize(finder.strongly_connected_components());
+    }
+    size_t bytes = 2 * (graph.offset.size_bytes() + graph.adj.size_bytes());
+    report(state, perf, (double)n + (double)edges.size(), bytes);
+}
+
+// ------------------------------------------------------------------ Registration
+
+// Registers `fn(state, arg)` as `name/N` for every swept size
+template<typename Fn, typename Arg>
+benchmark::internal::Benchmark* add(const std::string& name, Fn fn, Arg arg) {
+    return benchmark::RegisterBenchmark(name.c_str(), [=](benchmark::State& state) { fn(state, arg); })->Apply(size_sweep);
+}
+
+int main(int argc, char** argv) {
+    add("BM_DSU<DSU<>>/random", BM_DSU<DSU<>>, Random);
+    add("BM_DSU<DSU<>>/adversarial", BM_DSU<DSU<>>, Adversarial);
+    add("BM_DSU<DSU<true>>/random", BM_DSU<DSU<true>>, Random);
+    add("BM_DSU<DSU<true>>/adversarial", BM_DSU<DSU<true>>, Adversarial);
+    add("BM_DSU<CompactDSU<>>/random", BM_DSU<CompactDSU<>>, Random);
+    add("BM_DSU<CompactDSU<>>/adversarial", BM_DSU<CompactDSU<>>, Adversarial);
+
+    // Every engine over int64_t: sums of 10^8 values below 1000 overflow int32
+    add("BM_SegTree<SegTree<int64_t>>/uniform", BM_SegTree<SegTree<int64_t>>, Uniform);
+    add("BM_SegTree<SegTree<int64_t>>/clustered", BM_SegTree<SegTree<int64_t>>, Clustered);
+    add("BM_SegTree<IterSegTree<int64_t>>/uniform", BM_SegTree<IterSegTree<int64_t>>, Uniform);
+    add("BM_SegTree<IterSegTree<int64_t>>/clustered", BM_SegTree<IterSegTree<int64_t>>, Clustered);
+    add("BM_SegTree<WideSegTree<int64_t>>/uniform", BM_SegTree<WideSegTree<int64_t>>, Uniform);
+    add("BM_SegTree<WideSegTree<int64_t>>/clustered", BM_SegTree<WideSegTree<int64_t>>, Clustered);
+    add("BM_SegTree<SimdSegTree<int64_t>>/uniform", BM_SegTree<SimdSegTree<int64_t>>, Uniform);
+    add("BM_SegTree<SimdSegTree<int64_t>>/clustered", BM_SegTree<SimdSegTree<int64_t>>, Clustered);
+
+    add("BM_LCA<LCA>/random_tree", BM_LCA<LCA>, RandomTree);
+    add("BM_LCA<LCA>/path_tree", BM_LCA<LCA>, PathTree);
+    add("BM_LCA<LCAEuler>/random_tree", BM_LCA<LCAEuler>, RandomTree);
+    add("BM_LCA<LCAEuler>/path_tree", BM_LCA<LCAEuler>, PathTree);
+
+    add("BM_FindCycle/dag", BM_FindCycle, Acyclic);
+    add("BM_FindCycle/cyclic", BM_FindCycle, Cyclic);
+
+    for (int threads : {1, 2, 4, 8}) {
+        // Wall time: CPU time of the main thread alone would flatter more threads
+        add("BM_GiantSCC/threads:" + std::to_string(threads), BM_GiantSCC, threads)->UseRealTime();
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * =====================================================================================
+ * Data Structure: Concurrent Disjoint Set Union (Lock-Free Union-Find)
+ * Description:    Thread-safe version of `DSU` (see dsu.cpp). Any number of threads
+ * may call find_set, union_sets and same_set at the same time.
+ * =====================================================================================
+ * * Time Complexity: O(log N) per operation with high probability, close to
+ * O(α(N)) in practice (Jayanti & Tarjan, "Concurrent Disjoint Set Union").
+ * * Space Complexity: O(N), a single array of atomic parents.
+ * * =====================================================================================
+ * * How it works:
+ * 1. Atomic parents: Every parent pointer is a `std::atomic<int>`. A node only ever
+ * moves towards a root, so any parent read is a valid ancestor.
+ * 2. Path Halving with CAS: find_set points each visited node to its grandparent
+ * with a single compare-exchange. A failed CAS just means another thread already
+ * shortened that link, so no thread ever waits for another.
+ * 3. Linking by Random Priority: A root is only ever linked below a root with a
+ * higher priority, which rules out cycles and keeps trees shallow. Priorities are a
+ * fixed bijective hash of the index, so they cost no memory.
+ * 4. CAS Linking: union_sets links `b` under `a` with CAS(parent[b], b, a). If `b`
+ * stopped being a root in the meantime, the CAS fails and the union retries.
+ * * =====================================================================================
+ * * How to Use:
+ * - `ConcurrentDSU dsu(n);`        // Create a DSU structure for n elements (0 to n-1).
+ * - `dsu.find_set(i);`             // Returns the current representative of i.
+ * - `dsu.union_sets(i, j);`        // Merges the sets; true if they were different.
+ * - `dsu.same_set(i, j);`          // Linearizable "are i and j connected?" check.
+ * * Representatives may change while other threads keep merging, so compare with
+ * same_set instead of comparing two separate find_set results.
+ * =====================================================================================
+ */
+#ifndef CODEBOOK_CONCURRENT_DSU
+#define CODEBOOK_CONCURRENT_DSU
+#include <bits/stdc++.h>
+
+struct ConcurrentDSU {
+    std::vector<std::atomic<int>> parent;
+
+    // Constructor to initialize the DSU for 'n' elements
+    ConcurrentDSU(int n) : parent(n) {
+        for (int i = 0; i < n; ++i) parent[i].store(i, std::memory_order_relaxed);
+    }
+
+    // Find the representative of the set containing 'v' with path halving
+    int find_set(int v) {
+        while (true) {
+            int p = parent[v].load(std::memory_order_acquire);
+            if (p == v)
+                return v;
+            int gp = parent[p].load(std::memory_order_acquire);
+            if (p != gp) {
+                // Halve the path; losing the race is harmless.
+                parent[v].compare_exchange_weak(p, gp, std::memory_order_release,
+                                                std::memory_order_relaxed);
+            }
+            v = gp;
+        }
+    }
+
+    // Union the sets containing 'a' and 'b'. Returns false if already joined
+    bool union_sets(int a, int b) {
+        while (true) {
+            a = find_set(a);
+            b = find_set(b);
+            if (a == b)
+                return false;
+            // Attach the lower-priority root below the higher-priority one
+            if (priority(a) < priority(b))
+                std::swap(a, b);
+            int expected = b;
+            if (parent[b].compare_exchange_strong(expected, a, std::memory_order_acq_rel,
+                                                  std::memory_order_relaxed))
+                return true;
+            // 'b' was linked by someone else first: retry from the new roots
+        }
+    }
+
+    // Are 'a' and 'b' in the same set? Safe under concurrent unions
+    bool same_set(int a, int b) {
+        while (true) {
+            a = find_set(a);
+            b = find_set(b);
+            if (a == b)
+                return true;
+            // If 'a' is still a root, it was a root while 'b' was found
+            // elsewhere, so the two were disjoint at that moment.
+            if (parent[a].load(std::memory_order_acquire) == a)
+                return false;
+        }
+    }
+
+private:
+    // Bijective mixing of the index (odd multiplier), acting as a random priority
+    static uint32_t priority(int v) {
+        return static_cast<uint32_t>(v) * 0x9E3779B1u;
+    }
+};
+
+// --- Example Usage ---
+// int main() {
+//     int n = 1000000;
+//     ConcurrentDSU dsu(n);
+//
+//      Four threads merge disjoint slices of a chain 0 - 1 - 2 - ... - (n-1)
+//     std::vector<std::thread> workers;
+//     for (int w = 0; w < 4; ++w) {
+//         workers.emplace_back([&, w] {
+//             for (int i = w; i + 1 < n; i += 4) dsu.union_sets(i, i + 1);
+//         });
+//     }
+//     for (auto& th : workers) th.join();
+//
+//     std::cout << "Same(0, n-1)? " << (dsu.same_set(0, n - 1) ? "Yes" : "No") << std::endl;
+// }
+#endif // CODEBOOK_CONCURRENT_DSU
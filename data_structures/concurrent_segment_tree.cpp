@@ -0,0 +1,119 @@
+/**
+ * =====================================================================================
+ * Data Structure: Concurrent Segment Tree (RCU-style double buffer)
+ * Description:    Wraps any point-update segment tree from segment_tree.cpp so that
+ * reader threads can query while a writer applies batches, and readers never wait.
+ * =====================================================================================
+ * * Time Complexity:
+ * - query: that of the wrapped tree, plus two atomic increments.
+ * - update_batch: twice that of the wrapped tree (each batch is applied to both copies).
+ * * Space Complexity: Two copies of the tree.
+ * * =====================================================================================
+ * * How it works:
+ * 1. Two copies: Readers only ever see the "front" copy, which nobody writes. The
+ * writer applies a batch to the "back" copy and then publishes it with one atomic
+ * store, so a reader sees either all of a batch or none of it.
+ * 2. Reader pins: A reader increments the pin counter of the copy it is about to
+ * read, then checks that the copy is still the front one (otherwise it unpins and
+ * retries on the new front). It never blocks, and only retries if a swap
+ * happened between its two loads.
+ * 3. Lazy catch-up: Right after a swap the new back copy is one batch behind.
+ * That batch is replayed into it at the start of the *next* update_batch, once the
+ * readers still pinned to it have left. A writer waits for stragglers that started
+ * before the previous swap, but readers never wait for a writer.
+ * 4. One writer at a time: update_batch calls are serialised by a mutex.
+ * * =====================================================================================
+ * * How to Use:
+ * - `ConcurrentSegTree<IterSegTree<>> st(a);`     // Any tree with a const query(l, r)
+ * - `st.query(l, r);`                              // From any number of threads
+ * - `st.update_batch(updates);`                    // {pos, value} writes, in order
+ * * Batches are atomic for readers: every query sees the tree before or after a
+ * whole batch. Use one(ish) batch per logical update, not one per point.
+ * =====================================================================================
+ */
+#ifndef CODEBOOK_CONCURRENT_SEGMENT_TREE
+#define CODEBOOK_CONCURRENT_SEGMENT_TREE
+#include "segment_tree.cpp"
+
+template <typename Tree = IterSegTree<>>
+struct ConcurrentSegTree {
+    using T = std::remove_cvref_t<decltype(std::declval<const Tree&>().query(0, 0))>;
+
+    Tree copies[2];
+    std::atomic<int> front{0}; // the copy readers use
+    struct alignas(64) Pins {
+        std::atomic<int> count{0}; // readers currently inside this copy
+    };
+    mutable Pins pins[2];
+    std::mutex writer;
+    std::vector<std::pair<int, T>> behind; // last batch, still missing from the back copy
+
+    // Constructor to build from a vector; both copies start out equal
+    template <typename U>
+    ConcurrentSegTree(const std::vector<U>& a) : copies{Tree(a), Tree(a)} {}
+
+    // Query for a range [l, r]: wait-free in the absence of swaps, lock-free overall
+    T query(int l, int r) const {
+        int i = pin();
+        T res = copies[i].query(l, r);
+        pins[i].count.fetch_sub(1, std::memory_order_release);
+        return res;
+    }
+
+    // Apply point writes `updates[i] = {pos, new_val}` in order, then publish them
+    void update_batch(std::span<const std::pair<int, T>> updates) {
+        std::lock_guard<std::mutex> guard(writer);
+        int back = 1 - front.load(std::memory_order_relaxed);
+        // Readers that pinned 'back' before the last swap may still be inside
+        while (pins[back].count.load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+        apply(copies[back], behind);
+        apply(copies[back], updates);
+        front.store(back, std::memory_order_seq_cst);
+        behind.assign(updates.begin(), updates.end());
+    }
+
+    // Single point write, published on its own
+    void update(int pos, T new_val) {
+        std::pair<int, T> one{pos, new_val};
+        update_batch({&one, 1});
+    }
+
+private:
+    // Pin the front copy, so the writer leaves it alone until we unpin
+    int pin() const {
+        while (true) {
+            int i = front.load(std::memory_order_seq_cst);
+            pins[i].count.fetch_add(1, std::memory_order_seq_cst);
+            if (front.load(std::memory_order_seq_cst) == i) return i;
+            pins[i].count.fetch_sub(1, std::memory_order_release); // swapped meanwhile
+        }
+    }
+
+    static void apply(Tree& tree, std::span<const std::pair<int, T>> updates) {
+        if constexpr (requires { tree.update_batch(updates); }) {
+            tree.update_batch(updates);
+        } else {
+            for (const auto& [pos, val] : updates) tree.update(pos, val);
+        }
+    }
+};
+
+// --- Example Usage ---
+// int main() {
+//     std::vector<long long> a(1 << 20, 1);
+//     ConcurrentSegTree<IterSegTree<>> st(a);
+//     std::atomic<bool> done{false};
+//     std::thread reader([&] {
+//         while (!done) assert(st.query(0, (1 << 20) - 1) % (1 << 20) == 0);
+//     });
+//     for (int round = 0; round < 100; ++round) {
+//         std::vector<std::pair<int, long long>> batch;
+//         for (int i = 0; i < (1 << 20); i += 4096) batch.push_back({i, round % 2 ? 1 : 4097});
+//         st.update_batch(batch); // the total stays a multiple of 2^20 after every batch
+//     }
+//     done = true;
+//     reader.join();
+// }
+#endif // CODEBOOK_CONCURRENT_SEGMENT_TREE
@@ -13,16 +13,35 @@
  * to the root. This flattens the tree.
  * 2. Union by Size: When merging sets, we always attach the smaller tree to the
  * root of the larger tree. This keeps the trees from becoming too deep.
+ * 3. Iterative Path Halving (optional, `DSU<true>`): find_set walks up in a loop and
+ * points every other node to its grandparent. Same O(α(N)) bound, but no recursion,
+ * so long chains built by adversarial union orders can't overflow the stack.
+ * 4. compress_all(): Flattens every tree in one linear pass. After bulk loading,
+ * every find_set in a read-only phase is a single memory hop.
+ * 5. Compact Storage (`CompactDSU<Index>`): One array instead of two. A root stores
+ * minus the size of its set, any other node stores its parent. That is one `Index`
+ * per element and one cache line per visited node. Use `int32_t` (the default) for
+ * up to 2^31 - 1 elements and `int64_t` beyond that.
  * * =====================================================================================
  * * How to Use:
  * - `DSU dsu(n);`             // Create a DSU structure for n elements (0 to n-1).
+ * - `DSU<true> dsu(n);`       // Same, with the iterative path-halving find_set.
  * - `dsu.find_set(i);`        // Returns the representative of the set containing i.
  * - `dsu.union_sets(i, j);`   // Merges the sets containing i and j.
  * - `dsu.size[dsu.find_set(i)];` // Gets the size of the set containing i.
+ * - `dsu.compress_all();`     // Points every element directly at its root.
+ * - `CompactDSU<int64_t> big(n);` // Packed variant; `big.set_size(i)` gives the size.
+ * * Profiling: build with `-DCODEBOOK_STATS` to count finds, unions and find path
+ * lengths in `dsu_stats` (utils/stats.cpp); `dsu_stats.dump()` prints them.
  * =====================================================================================
  */
+// Include guard instead of `#pragma once`: this file is also a main file.
+#ifndef CODEBOOK_DSU
+#define CODEBOOK_DSU
 #include <bits/stdc++.h>
+#include "../utils/stats.cpp"
 
+template <bool PathHalving = false>
 struct DSU {
     std::vector<int> parent;
     std::vector<int> sz; // 'sz' stores the size of each set
@@ -37,16 +56,40 @@ struct DSU {
 
     // Find the representative of the set containing 'v' with path compression
     int find_set(int v) {
-        if (v == parent[v])
+        CODEBOOK_STATS_ONLY(record_find(v);)
+        if constexpr (PathHalving) {
+            while (v != parent[v]) {
+                parent[v] = parent[parent[v]]; // skip to the grandparent
+                v = parent[v];
+            }
             return v;
-        return parent[v] = find_set(parent[v]);
+        } else {
+            return find_recursive(v);
+        }
+    }
+
+    // Point every element directly at its root, without recursion.
+    // Each node is re-linked at most once, so the whole pass is O(N).
+    void compress_all() {
+        for (int v = 0; v < (int)parent.size(); ++v) {
+            int root = v;
+            while (root != parent[root])
+                root = parent[root];
+            for (int x = v; parent[x] != root;) {
+                int next = parent[x];
+                parent[x] = root;
+                x = next;
+            }
+        }
     }
 
     // Union the sets containing 'a' and 'b' with union by size
     void union_sets(int a, int b) {
+        CODEBOOK_STATS_ONLY(stats_bump(dsu_stats.unions);)
         a = find_set(a);
         b = find_set(b);
         if (a != b) {
+            CODEBOOK_STATS_ONLY(stats_bump(dsu_stats.links);)
             // Attach the smaller tree to the root of the larger tree
             if (sz[a] < sz[b])
                 std::swap(a, b);
@@ -54,10 +97,95 @@ struct DSU {
             sz[a] += sz[b]; // Update the size of the new merged set
         }
     }
+
+private:
+    int find_recursive(int v) {
+        if (v == parent[v])
+            return v;
+        return parent[v] = find_recursive(parent[v]);
+    }
+
+    // CODEBOOK_STATS: the path length before find_set shortens it
+    void record_find(int v) const {
+        uint64_t len = 0;
+        for (; v != parent[v]; v = parent[v]) ++len;
+        stats_bump(dsu_stats.finds);
+        dsu_stats.path.add(len);
+    }
 };
 
-// --- Example Usage ---
+template <typename Index = int32_t>
+struct CompactDSU {
+    static_assert(std::is_signed_v<Index>, "negative entries mark the roots");
+
+    // parent[v] < 0: 'v' is a root and -parent[v] is the size of its set
+    // parent[v] >= 0: the parent of 'v'
+    std::vector<Index> parent;
+
+    // Constructor to initialize the DSU for 'n' elements
+    CompactDSU(Index n) {
+        parent.assign(n, -1); // Each set initially has size 1
+    }
 
+    // Find the representative of the set containing 'v' with path halving
+    Index find_set(Index v) {
+        CODEBOOK_STATS_ONLY(record_find(v);)
+        while (parent[v] >= 0) {
+            Index p = parent[v];
+            if (parent[p] >= 0)
+                parent[v] = parent[p]; // skip to the grandparent
+            v = parent[v];
+        }
+        return v;
+    }
+
+    // Union the sets containing 'a' and 'b' with union by size
+    void union_sets(Index a, Index b) {
+        CODEBOOK_STATS_ONLY(stats_bump(dsu_stats.unions);)
+        a = find_set(a);
+        b = find_set(b);
+        if (a != b) {
+            CODEBOOK_STATS_ONLY(stats_bump(dsu_stats.links);)
+            // Sizes are stored negated: the larger set has the smaller entry
+            if (parent[a] > parent[b])
+                std::swap(a, b);
+            parent[a] += parent[b];
+            parent[b] = a;
+        }
+    }
+
+    // Size of the set containing 'v'
+    Index set_size(Index v) {
+        return -parent[find_set(v)];
+    }
+
+    // Point every element directly at its root in one O(N) pass
+    void compress_all() {
+        for (Index v = 0; v < (Index)parent.size(); ++v) {
+            Index root = v;
+            while (parent[root] >= 0)
+                root = parent[root];
+            for (Index x = v; x != root && parent[x] != root;) {
+                Index next = parent[x];
+                parent[x] = root;
+                x = next;
+            }
+        }
+    }
+
+private:
+    // CODEBOOK_STATS: the path length before find_set shortens it
+    void record_find(Index v) const {
+        uint64_t len = 0;
+        for (; parent[v] >= 0; v = parent[v]) ++len;
+        stats_bump(dsu_stats.finds);
+        dsu_stats.path.add(len);
+    }
+};
+
+// --- Example Usage ---
+// Compiled only when this file is built directly, so other files can include it.
+#if __INCLUDE_LEVEL__ == 0
 int main() {
     // Let's say we have 5 elements, numbered 0 to 4
     int n = 5;
@@ -80,5 +208,20 @@ int main() {
     int root = dsu.find_set(3);
     std::cout << "Size of the set containing 3 is: " << dsu.sz[root] << std::endl;
 
+    // Iterative find_set: safe on very long chains
+    int m = 1000000;
+    DSU<true> chain(m);
+    for (int i = 0; i + 1 < m; ++i) chain.union_sets(i + 1, i);
+    chain.compress_all(); // one hop per find_set from here on
+    std::cout << "Find(0) == Find(m-1)? " << (chain.find_set(0) == chain.find_set(m - 1) ? "Yes" : "No") << std::endl;
+
+    // Packed variant: 4 bytes per element, or 8 with int64_t for > 2^31 elements
+    CompactDSU<int64_t> packed(n);
+    packed.union_sets(0, 4);
+    packed.union_sets(4, 2);
+    std::cout << "Size of the set containing 2 is: " << packed.set_size(2) << std::endl;
+
     return 0;
-}
\ No newline at end of file
+}
+#endif
+#endif // CODEBOOK_DSU
@@ -0,0 +1,224 @@
+/**
+ * =================================================================
+ * Lazy Segment Tree (Generic, Range Update + Range Query)
+ * =================================================================
+ *
+ * Description:
+ * Extends `SegTree` (see segment_tree.cpp) with range updates. An
+ * update on [l, r] stops at the O(log N) canonical nodes that cover the
+ * range and leaves a "lazy" tag there; tags are pushed to the children
+ * only when a later operation needs to go below that node.
+ *
+ * Values use the same monoids as `SegTree` (`SumMonoid`, `MinMonoid`,
+ * ...). Updates are described by an Action, which bundles:
+ * - `F`:                      The tag type stored per node.
+ * - `identity()`:             The "do nothing" tag.
+ * - `compose(f, g)`:          The tag for "apply g, then f".
+ * - `apply(f, x, len)`:       The new aggregate of a node holding `x`
+ * over `len` elements after applying `f` to every one of them.
+ *
+ * Node values `t` and lazy tags `lz` live in two separate arrays, so a
+ * query touches a dense array of values and only reads the tag array
+ * along the root-to-border paths it actually descends.
+ *
+ * Queries never push: the tags on the way down are composed and applied
+ * to the nodes that answer the query. So `query` is `const`, and any
+ * number of threads may query one instance at the same time (updates
+ * still need exclusive access).
+ *
+ * Complexity:
+ * - Build: O(N)
+ * - Range Query: O(log N)
+ * - Range Apply: O(log N)
+ * - Space: O(4*N) values + O(4*N) tags
+ *
+ * Ready-made actions (for sum, min and max monoids):
+ * - `AddAction`:    a[i] += x
+ * - `AssignAction`: a[i] = x
+ * - `AffineAction`: a[i] = mul * a[i] + add  (mul >= 0 for min / max)
+ *
+ */
+
+#ifndef CODEBOOK_LAZY_SEGMENT_TREE
+#define CODEBOOK_LAZY_SEGMENT_TREE
+#include "segment_tree.cpp"
+
+// Sum aggregates grow with the segment length when every element is
+// shifted; min / max aggregates are shifted once.
+template <typename Monoid>
+struct scales_with_length : std::false_type {};
+template <typename T>
+struct scales_with_length<SumMonoid<T>> : std::true_type {};
+
+template <typename T, typename Monoid>
+struct AddAction {
+    using F = T;
+    static constexpr F identity() { return F(0); }
+    static constexpr F compose(const F& f, const F& g) { return f + g; }
+    static constexpr T apply(const F& f, const T& x, int len) {
+        if constexpr (scales_with_length<Monoid>::value) return x + f * len;
+        else return x + f;
+    }
+};
+
+template <typename T, typename Monoid>
+struct AssignAction {
+    using F = std::optional<T>; // std::nullopt means "no pending assignment"
+    static constexpr F identity() { return std::nullopt; }
+    static constexpr F compose(const F& f, const F& g) { return f ? f : g; }
+    static constexpr T apply(const F& f, const T& x, int len) {
+        if (!f) return x;
+        if constexpr (scales_with_length<Monoid>::value) return *f * len;
+        else return *f;
+    }
+};
+
+template <typename T, typename Monoid>
+struct AffineAction {
+    struct F {
+        T mul, add;
+    };
+    static constexpr F identity() { return {T(1), T(0)}; }
+    static constexpr F compose(const F& f, const F& g) {
+        return {f.mul * g.mul, f.mul * g.add + f.add};
+    }
+    static constexpr T apply(const F& f, const T& x, int len) {
+        if constexpr (scales_with_length<Monoid>::value) return f.mul * x + f.add * len;
+        else return f.mul * x + f.add;
+    }
+};
+
+template <typename T = long long, typename Monoid = SumMonoid<T>,
+          typename Action = AddAction<T, Monoid>>
+struct LazySegTree {
+    using F = typename Action::F;
+
+    int n;
+    std::vector<T> t;  // node aggregates
+    std::vector<F> lz; // pending tags, kept apart from `t`
+
+    static T merge(const T& a, const T& b) { return Monoid{}(a, b); }
+
+    // Constructor to build from a vector (of `T`, or anything convertible to `T`)
+    template <typename U>
+    LazySegTree(const std::vector<U>& a) {
+        n = a.size();
+        t.resize(4 * n);
+        lz.assign(4 * n, Action::identity());
+        build(a, 1, 0, n - 1);
+    }
+
+    // --- Private Helper Functions (the "engine") ---
+private:
+    template <typename U>
+    void build(const std::vector<U>& a, int v, int tl, int tr) {
+        if (tl == tr) {
+            t[v] = static_cast<T>(a[tl]);
+        } else {
+            int tm = tl + (tr - tl) / 2;
+            build(a, v * 2, tl, tm);
+            build(a, v * 2 + 1, tm + 1, tr);
+            t[v] = merge(t[v * 2], t[v * 2 + 1]);
+        }
+    }
+
+    // Apply `f` to the whole segment of node `v` ([tl, tr])
+    void apply_node(int v, int tl, int tr, const F& f) {
+        t[v] = Action::apply(f, t[v], tr - tl + 1);
+        if (tl != tr) lz[v] = Action::compose(f, lz[v]);
+    }
+
+    // Hand the pending tag of `v` down to its two children
+    void push(int v, int tl, int tm, int tr) {
+        apply_node(v * 2, tl, tm, lz[v]);
+        apply_node(v * 2 + 1, tm + 1, tr, lz[v]);
+        lz[v] = Action::identity();
+    }
+
+    // `above` is the composition of the pending tags on the path to `v`,
+    // applied on the fly instead of pushed: the query never writes
+    T query_recursive(int v, int tl, int tr, int l, int r, const F& above) const {
+        if (l > r) {
+            return Monoid::identity();
+        }
+        if (l == tl && r == tr) {
+            return Action::apply(above, t[v], tr - tl + 1);
+        }
+        int tm = tl + (tr - tl) / 2;
+        F down = Action::compose(above, lz[v]);
+        T left_res = query_recursive(v * 2, tl, tm, l, std::min(r, tm), down);
+        T right_res = query_recursive(v * 2 + 1, tm + 1, tr, std::max(l, tm + 1), r, down);
+        return merge(left_res, right_res);
+    }
+
+    void apply_recursive(int v, int tl, int tr, int l, int r, const F& f) {
+        if (l > r) {
+            return;
+        }
+        if (l == tl && r == tr) {
+            apply_node(v, tl, tr, f);
+            return;
+        }
+        int tm = tl + (tr - tl) / 2;
+        push(v, tl, tm, tr);
+        apply_recursive(v * 2, tl, tm, l, std::min(r, tm), f);
+        apply_recursive(v * 2 + 1, tm + 1, tr, std::max(l, tm + 1), r, f);
+        t[v] = merge(t[v * 2], t[v * 2 + 1]);
+    }
+
+    void update_recursive(int v, int tl, int tr, int pos, T new_val) {
+        if (tl == tr) {
+            t[v] = new_val;
+        } else {
+            int tm = tl + (tr - tl) / 2;
+            push(v, tl, tm, tr);
+            if (pos <= tm) {
+                update_recursive(v * 2, tl, tm, pos, new_val);
+            } else {
+                update_recursive(v * 2 + 1, tm + 1, tr, pos, new_val);
+            }
+            t[v] = merge(t[v * 2], t[v * 2 + 1]);
+        }
+    }
+
+    // --- Public Functions (the "steering wheel") ---
+public:
+    // Query for a range [l, r]
+    T query(int l, int r) const {
+        return query_recursive(1, 0, n - 1, l, r, Action::identity());
+    }
+
+    // Apply `f` to every element of the range [l, r]
+    void apply(int l, int r, const F& f) {
+        apply_recursive(1, 0, n - 1, l, r, f);
+    }
+
+    // Update a single position `pos` to `new_val`
+    void update(int pos, T new_val) {
+        update_recursive(1, 0, n - 1, pos, new_val);
+    }
+};
+
+// --- Example Usage ---
+// #include <iostream>
+// int main() {
+//     std::vector<int> initial_array = {1, 2, 3, 4, 5};
+//
+//      Range add, range sum (the defaults)
+//     LazySegTree st(initial_array);
+//     st.apply(1, 3, 10); // {1, 12, 13, 14, 5}
+//     std::cout << "Sum of [0, 2]: " << st.query(0, 2) << std::endl; // 26
+//
+//      Range assign, range min
+//     using Min = MinMonoid<long long>;
+//     LazySegTree<long long, Min, AssignAction<long long, Min>> mn(initial_array);
+//     mn.apply(0, 2, 7);  // {7, 7, 7, 4, 5}
+//     std::cout << "Min of [0, 2]: " << mn.query(0, 2) << std::endl; // 7
+//
+//      Range affine (a[i] = 2 * a[i] + 1), range sum
+//     using Sum = SumMonoid<long long>;
+//     LazySegTree<long long, Sum, AffineAction<long long, Sum>> af(initial_array);
+//     af.apply(0, 4, {2, 1}); // {3, 5, 7, 9, 11}
+//     std::cout << "Sum of [0, 4]: " << af.query(0, 4) << std::endl; // 35
+// }
+#endif // CODEBOOK_LAZY_SEGMENT_TREE
@@ -0,0 +1,97 @@
+/**
+ * =====================================================================================
+ * Data Structure: Rollback Disjoint Set Union (Union-Find with Undo)
+ * Description:    A `DSU` (see dsu.cpp) whose unions can be undone in LIFO order.
+ * Take a snapshot, perform any number of unions, then roll back to the snapshot.
+ * =====================================================================================
+ * * Time Complexity:
+ * - find_set / union_sets: O(log N) (union by size, no path compression)
+ * - rollback: O(1) per undone union
+ * * Space Complexity: O(N) for the parent and size arrays, plus one entry per
+ * successful union on the undo stack.
+ * * =====================================================================================
+ * * Why no path compression?
+ * Compression rewrites many parent pointers on every find, which would all have to
+ * be recorded to undo them. With union by size alone every union changes exactly one
+ * parent and one size, and the trees stay O(log N) deep.
+ * * =====================================================================================
+ * * How to Use:
+ * - `RollbackDSU dsu(n);`       // Create a DSU structure for n elements (0 to n-1).
+ * - `dsu.union_sets(i, j);`     // Merges the sets; true if they were different.
+ * - `int s = dsu.snapshot();`   // Remembers the current state.
+ * - `dsu.rollback(s);`          // Undoes every union made after snapshot 's'.
+ * - `dsu.components`            // Number of disjoint sets right now.
+ * =====================================================================================
+ */
+#ifndef CODEBOOK_ROLLBACK_DSU
+#define CODEBOOK_ROLLBACK_DSU
+#include <bits/stdc++.h>
+
+struct RollbackDSU {
+    std::vector<int> parent;
+    std::vector<int> sz;      // 'sz' stores the size of each set
+    std::vector<int> history; // roots that got attached, in union order
+    int components;
+
+    // Constructor to initialize the DSU for 'n' elements
+    RollbackDSU(int n) : components(n) {
+        parent.resize(n);
+        std::iota(parent.begin(), parent.end(), 0);
+        sz.assign(n, 1);
+    }
+
+    // Find the representative of the set containing 'v' (read-only walk)
+    int find_set(int v) const {
+        while (v != parent[v])
+            v = parent[v];
+        return v;
+    }
+
+    bool same_set(int a, int b) const {
+        return find_set(a) == find_set(b);
+    }
+
+    // Union the sets containing 'a' and 'b' with union by size
+    bool union_sets(int a, int b) {
+        a = find_set(a);
+        b = find_set(b);
+        if (a == b)
+            return false;
+        if (sz[a] < sz[b])
+            std::swap(a, b);
+        parent[b] = a;
+        sz[a] += sz[b];
+        history.push_back(b);
+        --components;
+        return true;
+    }
+
+    // Handle to the current state
+    int snapshot() const {
+        return history.size();
+    }
+
+    // Undo every union performed after 'snap' was taken
+    void rollback(int snap) {
+        while ((int)history.size() > snap) {
+            int b = history.back();
+            history.pop_back();
+            sz[parent[b]] -= sz[b];
+            parent[b] = b;
+            ++components;
+        }
+    }
+};
+
+// --- Example Usage ---
+// int main() {
+//     RollbackDSU dsu(4);
+//     dsu.union_sets(0, 1);
+//     int s = dsu.snapshot();
+//     dsu.union_sets(1, 2);
+//     std::cout << dsu.same_set(0, 2) << std::endl; // 1
+//     dsu.rollback(s);
+//     std::cout << dsu.same_set(0, 2) << std::endl; // 0
+//     std::cout << dsu.same_set(0, 1) << std::endl; // 1
+// }
+#endif // CODEBOOK_ROLLBACK_DSU
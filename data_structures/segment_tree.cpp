@@ -5,51 +5,127 @@
  *
  * Description:
  * A data structure for efficient range queries and point updates.
- * It's generic and can be adapted for sum, min, max, gcd, xor, etc.
- * This is the foundational version without lazy propagation.
+ * It's generic over the value type `T` and a `Monoid` (sum, min, max,
+ * gcd, xor, ...). This is the foundational version without lazy propagation.
+ *
+ * Two engines with the same `query(l, r)` / `update(pos, val)` API:
+ * - `SegTree`:     Classic recursive top-down tree, 1-indexed heap in 4*N.
+ * - `IterSegTree`: Non-recursive bottom-up tree in 2*N. Leaves live at
+ * `[n, 2n)` and node `v` has children `2v` and `2v+1`. Queries keep
+ * separate left and right accumulators, so non-commutative merges
+ * (matrix product, string hashing, ...) are combined in the right order.
  *
  * Complexity:
  * - Build: O(N)
  * - Range Query: O(log N)
  * - Point Update: O(log N)
- * - Space: O(4*N)
+ * - Space: O(4*N) for `SegTree`, O(2*N) for `IterSegTree`
+ *
+ * Batched API (`IterSegTree`, requires C++20 for `std::span`):
+ * - `query_batch(queries, out)`: Answers many independent [l, r] queries.
+ * They are walked in order of their left border so neighbouring queries
+ * reuse the same warm tree paths, and the leaves of the next query are
+ * prefetched while the current one runs. `out[i]` answers `queries[i]`.
+ * - `update_batch(updates)`: Applies many point writes (later writes win)
+ * and recomputes every touched internal node exactly once.
+ *
+ * Multi-core (both take an optional `threads`, default 1 = serial):
+ * - Build: `SegTree(a, threads)` builds about 4 independent subtrees per
+ * thread, then merges the few nodes above them. `IterSegTree(a, threads)`
+ * copies the leaves in parallel chunks and then fills one index range
+ * [2^k, 2^(k+1)) at a time, bottom up; each range only reads the one
+ * below it, so its chunks never conflict.
+ * - `update_batch(updates, threads)`: updates are partitioned by their
+ * ancestor at a fixed depth, so every thread rebuilds its own disjoint
+ * subtrees; the shared nodes above them are rebuilt once at the end.
+ * Small inputs stay on the calling thread.
+ *
+ * Thread safety: `query` and `query_batch` are `const` and only read the
+ * tree, so any number of threads may query one instance at the same time.
+ * Updates need exclusive access; for readers that must never wait behind
+ * a writer, see `ConcurrentSegTree` (concurrent_segment_tree.cpp).
+ *
+ * Profiling: built with `-DCODEBOOK_STATS`, `query` and `update` of both
+ * engines record the nodes they visit and their depth in `segtree_stats`
+ * (utils/stats.cpp). Without it the hooks compile to nothing.
  *
  * How to Adapt for Different Problems:
- * 1.  Change the `IDENTITY` value. This is the value that doesn't affect
- * the merge operation (e.g., 0 for sum, infinity for min).
- * 2.  Change the `merge` function logic (e.g., use `a + b` for sum,
- * `std::min(a, b)` for min).
+ * Pick (or write) a monoid: a stateless struct with
+ * - `static constexpr T identity()`: the value that doesn't affect the
+ * merge (e.g., 0 for sum, infinity for min).
+ * - `constexpr T operator()(const T& a, const T& b) const`: the merge
+ * (e.g., `a + b` for sum, `std::min(a, b)` for min).
+ * Both are resolved at compile time, so `merge` inlines fully and the
+ * tree itself carries no per-object configuration.
  *
  */
 
+// Include guard instead of `#pragma once`: this file is also a main file.
+#ifndef CODEBOOK_SEGMENT_TREE
+#define CODEBOOK_SEGMENT_TREE
 #include <bits/stdc++.h>
+#include "../utils/parallel_chunks.cpp"
+#include "../utils/stats.cpp"
 
-// The `long long` type can be changed to `int` or another type if needed.
-using T = long long;
+// --- Ready-made monoids ---
 
+template <typename T>
+struct SumMonoid {
+    static constexpr T identity() { return T(0); }
+    constexpr T operator()(const T& a, const T& b) const { return a + b; }
+};
+
+template <typename T>
+struct MinMonoid {
+    static constexpr T identity() { return std::numeric_limits<T>::max(); }
+    constexpr T operator()(const T& a, const T& b) const { return std::min(a, b); }
+};
+
+template <typename T>
+struct MaxMonoid {
+    static constexpr T identity() { return std::numeric_limits<T>::lowest(); }
+    constexpr T operator()(const T& a, const T& b) const { return std::max(a, b); }
+};
+
+template <typename T>
+struct GcdMonoid {
+    static constexpr T identity() { return T(0); }
+    constexpr T operator()(const T& a, const T& b) const { return std::gcd(a, b); }
+};
+
+template <typename T = long long, typename Monoid = SumMonoid<T>>
 struct SegTree {
     int n;
     std::vector<T> t;
 
-    // =========== MODIFY THESE TWO LINES FOR THE PROBLEM ===========
-    const T IDENTITY = 0; // For sum. For min, use a large value (LLONG_MAX).
-    T merge(T a, T b) {
-        return a + b; // For sum. For min, use std::min(a, b).
-    }
-    // =================================================================
+    // The monoid is stateless: merge compiles down to the inlined operator.
+    static T merge(const T& a, const T& b) { return Monoid{}(a, b); }
 
-    // Constructor to build from a vector
-    SegTree(const std::vector<int>& a) {
+    // Constructor to build from a vector (of `T`, or anything convertible to `T`)
+    template <typename U>
+    SegTree(const std::vector<U>& a, int threads = 1) {
         n = a.size();
         t.resize(4 * n);
-        build(a, 1, 0, n - 1);
+        if (threads <= 1 || n < PARALLEL_MIN) {
+            build(a, 1, 0, n - 1);
+            return;
+        }
+        // Subtrees at depth 'split' are disjoint: roughly 4 per thread
+        int split = std::bit_width(4u * threads - 1);
+        std::vector<std::array<int, 3>> roots;
+        collect_roots(1, 0, n - 1, split, roots);
+        parallel_chunks(threads, roots.size(), 1, [&](int b, int e) {
+            for (int i = b; i < e; ++i) build(a, roots[i][0], roots[i][1], roots[i][2]);
+        });
+        build_top(1, 0, n - 1, split);
     }
 
     // --- Private Helper Functions (the "engine") ---
 private:
-    void build(const std::vector<int>& a, int v, int tl, int tr) {
+    template <typename U>
+    void build(const std::vector<U>& a, int v, int tl, int tr) {
         if (tl == tr) {
-            t[v] = a[tl];
+            t[v] = static_cast<T>(a[tl]);
         } else {
             int tm = tl + (tr - tl) / 2; // Avoids overflow
             build(a, v * 2, tl, tm);
@@ -58,9 +134,32 @@ private:
         }
     }
 
-    T query_recursive(int v, int tl, int tr, int l, int r) {
+    // Nodes at depth 'split' (or leaves above it), left to right: {v, tl, tr}
+    static void collect_roots(int v, int tl, int tr, int split, std::vector<std::array<int, 3>>& roots) {
+        if (split == 0 || tl == tr) {
+            roots.push_back({v, tl, tr});
+            return;
+        }
+        int tm = tl + (tr - tl) / 2;
+        collect_roots(v * 2, tl, tm, split - 1, roots);
+        collect_roots(v * 2 + 1, tm + 1, tr, split - 1, roots);
+    }
+
+    // Merge the nodes above the roots of 'collect_roots', once those are built
+    void build_top(int v, int tl, int tr, int split) {
+        if (split == 0 || tl == tr) {
+            return;
+        }
+        int tm = tl + (tr - tl) / 2;
+        build_top(v * 2, tl, tm, split - 1);
+        build_top(v * 2 + 1, tm + 1, tr, split - 1);
+        t[v] = merge(t[v * 2], t[v * 2 + 1]);
+    }
+
+    T query_recursive(int v, int tl, int tr, int l, int r) const {
+        CODEBOOK_STATS_ONLY(StatsFrame frame;)
         if (l > r) {
-            return IDENTITY;
+            return Monoid::identity();
         }
         if (l == tl && r == tr) {
             return t[v];
@@ -72,6 +171,7 @@ private:
     }
 
     void update_recursive(int v, int tl, int tr, int pos, T new_val) {
+        CODEBOOK_STATS_ONLY(StatsFrame frame;)
         if (tl == tr) {
             t[v] = new_val;
         } else {
@@ -85,32 +185,237 @@ private:
         }
     }
 
+    template <typename F>
+    static void decompose_recursive(int v, int tl, int tr, int l, int r, F& f) {
+        if (l > r) {
+            return;
+        }
+        if (l == tl && r == tr) {
+            f(v, tl, tr);
+            return;
+        }
+        int tm = tl + (tr - tl) / 2;
+        decompose_recursive(v * 2, tl, tm, l, std::min(r, tm), f);
+        decompose_recursive(v * 2 + 1, tm + 1, tr, std::max(l, tm + 1), r, f);
+    }
+
     // --- Public Functions (the "steering wheel") ---
 public:
     // Query for a range [l, r]
-    T query(int l, int r) {
-        return query_recursive(1, 0, n - 1, l, r);
+    T query(int l, int r) const {
+        T res = query_recursive(1, 0, n - 1, l, r);
+        CODEBOOK_STATS_ONLY(stats_bump(segtree_stats.queries); stats_finish(segtree_stats.query_nodes);)
+        return res;
     }
 
     // Update a single position `pos` to `new_val`
     void update(int pos, T new_val) {
         update_recursive(1, 0, n - 1, pos, new_val);
+        CODEBOOK_STATS_ONLY(stats_bump(segtree_stats.updates); stats_finish(segtree_stats.update_nodes);)
+    }
+
+    // Call f(v, tl, tr) for each of the O(log N) canonical nodes covering
+    // [l, r] in a tree over `size` elements, left to right. Only the shape is
+    // used, so it also serves "segment tree over time" style algorithms.
+    template <typename F>
+    static void decompose(int size, int l, int r, F&& f) {
+        decompose_recursive(1, 0, size - 1, l, r, f);
+    }
+
+private:
+    static constexpr int PARALLEL_MIN = 1 << 16; // below this, threads cost more than they save
+};
+
+template <typename T = long long, typename Monoid = SumMonoid<T>>
+struct IterSegTree {
+    int n;
+    std::vector<T> t;
+
+    // The monoid is stateless: merge compiles down to the inlined operator.
+    static T merge(const T& a, const T& b) { return Monoid{}(a, b); }
+
+    // Constructor to build from a vector (of `T`, or anything convertible to `T`)
+    template <typename U>
+    IterSegTree(const std::vector<U>& a, int threads = 1) {
+        n = a.size();
+        t.resize(2 * n);
+        // Leaves go to [n, 2n), then every internal node is filled from its
+        // children. Going right to left guarantees children are ready.
+        if (threads <= 1) {
+            for (int i = 0; i < n; ++i) t[n + i] = static_cast<T>(a[i]);
+            for (int v = n - 1; v >= 1; --v) t[v] = merge(t[v * 2], t[v * 2 + 1]);
+            return;
+        }
+        parallel_chunks(threads, n, GRAIN, [&](int b, int e) {
+            for (int i = b; i < e; ++i) t[n + i] = static_cast<T>(a[i]);
+        });
+        // The children of [2^k, 2^(k+1)) are leaves or in the range below,
+        // so ranges are filled bottom up, each one split across threads
+        for (int k = std::bit_width((unsigned)n) - 1; k >= 0; --k) {
+            int lo = 1 << k, hi = (int)std::min(2LL * lo, (long long)n);
+            parallel_chunks(threads, std::max(0, hi - lo), GRAIN, [&](int b, int e) {
+                for (int v = lo + b; v < lo + e; ++v) t[v] = merge(t[v * 2], t[v * 2 + 1]);
+            });
+        }
+    }
+
+    // Query for a range [l, r]
+    T query(int l, int r) const {
+        T res_left = Monoid::identity(), res_right = Monoid::identity();
+        // Half-open [l, r) on the leaf level, climbing one level per step.
+        // A left border that is a right child is taken and moved past;
+        // same for a right border that is a left child.
+        for (l += n, r += n + 1; l < r; l >>= 1, r >>= 1) {
+            // CODEBOOK_STATS: the depth is the number of levels climbed
+            CODEBOOK_STATS_ONLY(stats_scope.nodes += (l & 1) + (r & 1); stats_scope.max_depth++;)
+            if (l & 1) res_left = merge(res_left, t[l++]);
+            if (r & 1) res_right = merge(t[--r], res_right);
+        }
+        CODEBOOK_STATS_ONLY(stats_bump(segtree_stats.queries); stats_finish(segtree_stats.query_nodes);)
+        return merge(res_left, res_right);
+    }
+
+    // Update a single position `pos` to `new_val`
+    void update(int pos, T new_val) {
+        pos += n;
+        t[pos] = new_val;
+        for (pos >>= 1; pos >= 1; pos >>= 1) {
+            CODEBOOK_STATS_ONLY(stats_scope.nodes++; stats_scope.max_depth++;)
+            t[pos] = merge(t[pos * 2], t[pos * 2 + 1]);
+        }
+        CODEBOOK_STATS_ONLY(stats_bump(segtree_stats.updates); stats_finish(segtree_stats.update_nodes);)
+    }
+
+    // Answer `queries[i]` ([l, r] inclusive) into `out[i]`
+    void query_batch(std::span<const std::pair<int, int>> queries, std::span<T> out) const {
+        std::vector<int> order(queries.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return queries[a] < queries[b];
+        });
+        for (size_t k = 0; k < order.size(); ++k) {
+            if (k + 1 < order.size()) {
+                // Bring the lowest levels of the next walk into cache; the
+                // upper levels are shared by every query and stay hot.
+                auto [nl, nr] = queries[order[k + 1]];
+                for (int i = 0, x = nl + n, y = nr + n; i < PREFETCH_LEVELS; ++i, x >>= 1, y >>= 1) {
+                    __builtin_prefetch(&t[x]);
+                    __builtin_prefetch(&t[y]);
+                }
+            }
+            auto [l, r] = queries[order[k]];
+            out[order[k]] = query(l, r);
+        }
+    }
+
+    // Apply point writes `updates[i] = {pos, new_val}` in order
+    void update_batch(std::span<const std::pair<int, T>> updates, int threads = 1) {
+        // Subtree roots [top, 2 * top) must be at or above every leaf: top <= n
+        int top = (int)std::min<unsigned>(std::bit_ceil(8u * std::max(1, threads)), std::bit_floor((unsigned)n));
+        if (threads <= 1 || (int)updates.size() < GRAIN || top < 2) {
+            std::vector<int> level;
+            for (const auto& [pos, val] : updates) {
+                t[pos + n] = val;
+                level.push_back(pos + n);
+            }
+            rebuild_ancestors(level, 1);
+            return;
+        }
+
+        // Thread i owns the subtrees of roots [top + i * top / threads, ...):
+        // bucket the updates by owner, keeping their order within a bucket
+        auto owner = [&](int leaf) {
+            int root = leaf >> (std::bit_width((unsigned)leaf) - std::bit_width((unsigned)top));
+            return (int)((long long)(root - top) * threads / top);
+        };
+        std::vector<int> start(threads + 1, 0), order(updates.size());
+        for (const auto& [pos, val] : updates) start[owner(pos + n) + 1]++;
+        std::partial_sum(start.begin(), start.end(), start.begin());
+        std::vector<int> fill(start.begin(), start.end() - 1);
+        for (int i = 0; i < (int)updates.size(); ++i) order[fill[owner(updates[i].first + n)]++] = i;
+
+        std::vector<std::vector<int>> roots(threads);
+        parallel_chunks(threads, threads, 1, [&](int b, int e) {
+            for (int i = b; i < e; ++i) {
+                std::vector<int> level;
+                for (int k = start[i]; k < start[i + 1]; ++k) {
+                    const auto& [pos, val] = updates[order[k]];
+                    t[pos + n] = val;
+                    level.push_back(pos + n);
+                }
+                roots[i] = rebuild_ancestors(level, top);
+            }
+        });
+        // Finally the nodes above the subtree roots, shared by every thread
+        std::vector<int> level;
+        for (auto& r : roots) level.insert(level.end(), r.begin(), r.end());
+        rebuild_ancestors(level, 1);
+    }
+
+private:
+    static constexpr int PREFETCH_LEVELS = 3;
+    static constexpr int GRAIN = 1 << 14; // fewest items worth a thread
+
+    // Recompute every internal ancestor v >= top of the nodes in 'level'
+    // (which are already up to date), each once and after its children.
+    // Returns the nodes of 'level' and their ancestors that are in [top, 2 * top).
+    std::vector<int> rebuild_ancestors(std::vector<int>& level, int top) {
+        std::vector<int> next, touched, reached;
+        // Collect every ancestor once, climbing one step per round and
+        // deduplicating as the paths merge towards the root.
+        std::sort(level.begin(), level.end());
+        while (!level.empty()) {
+            level.erase(std::unique(level.begin(), level.end()), level.end());
+            next.clear();
+            for (int v : level) {
+                if (v < 2 * top) reached.push_back(v);
+                if (v / 2 >= top) next.push_back(v >> 1); // stays sorted
+            }
+            level.swap(next);
+            touched.insert(touched.end(), level.begin(), level.end());
+        }
+        // A parent's index is always smaller than its children's, so going
+        // in decreasing index order rebuilds each node once, after its children.
+        std::sort(touched.begin(), touched.end(), std::greater<int>());
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+        for (int v : touched) t[v] = merge(t[v * 2], t[v * 2 + 1]);
+        return reached;
     }
 };
 
 // --- Example Usage ---
-// #include <iostream>
-// int main() {
-//     std::vector<int> initial_array = {1, 2, 3, 4, 5};
-//     SegTree st(initial_array);
-//
-//      Query sum of range [1, 3] (should be 2+3+4 = 9)
-//     std::cout << "Sum of [1, 3]: " << st.query(1, 3) << std::endl;
-//
-//      Update position 2 to value 10
-//     st.update(2, 10);
-//
-//      Query sum of range [1, 3] again. New array is {1, 2, 10, 4, 5}
-//      New sum should be 2 + 10 + 4 = 16
-//     std::cout << "New sum of [1, 3]: " << st.query(1, 3) << std::endl;
-// }
\ No newline at end of file
+// Compiled only when this file is built directly, so other files can include it.
+#if __INCLUDE_LEVEL__ == 0
+int main() {
+    std::vector<int> initial_array = {1, 2, 3, 4, 5};
+    SegTree st(initial_array); // SegTree<long long, SumMonoid<long long>>
+
+    // Query sum of range [1, 3] (should be 2+3+4 = 9)
+    std::cout << "Sum of [1, 3]: " << st.query(1, 3) << std::endl;
+
+    // Update position 2 to value 10
+    st.update(2, 10);
+
+    // Query sum of range [1, 3] again. New array is {1, 2, 10, 4, 5}
+    // New sum should be 2 + 10 + 4 = 16
+    std::cout << "New sum of [1, 3]: " << st.query(1, 3) << std::endl;
+
+    // Same API, bottom-up engine in 2*N memory
+    IterSegTree it(initial_array);
+    std::cout << "Sum of [1, 3]: " << it.query(1, 3) << std::endl;
+
+    // Other monoids are picked at compile time
+    std::vector<long long> big = {1LL << 40, 7, 1LL << 35};
+    IterSegTree<long long, MinMonoid<long long>> mn(big);
+    std::cout << "Min of [0, 2]: " << mn.query(0, 2) << std::endl;
+
+    // Batched queries and updates
+    std::vector<std::pair<int, int>> queries = {{0, 4}, {1, 3}, {2, 2}};
+    std::vector<long long> answers(queries.size());
+    it.query_batch(queries, answers);                 // {15, 9, 3}
+    std::vector<std::pair<int, long long>> writes = {{0, 10}, {4, 20}};
+    it.update_batch(writes);                          // {10, 2, 3, 4, 20}
+    return 0;
+}
+#endif
+#endif // CODEBOOK_SEGMENT_TREE
@@ -0,0 +1,217 @@
+/**
+ * =================================================================
+ * Wide (B-ary) Segment Tree
+ * =================================================================
+ *
+ * Description:
+ * A cache-friendly layout of the bottom-up segment tree. Instead of two
+ * children per node, every node has `B` children whose aggregates are
+ * stored next to each other, so one node is one cache line (the default
+ * `B` is `64 / sizeof(T)`: 16 x int, 8 x long long). The tree is kept as
+ * a stack of levels:
+ * - Level 0 holds the array itself, padded with identities up to a
+ * multiple of `B`.
+ * - Entry `j` of level `k` is the merge of block `j` (entries
+ * `[j*B, (j+1)*B)`) of level `k - 1`.
+ * Every level is block-aligned inside one contiguous, 64-byte aligned
+ * buffer, so a walk touches at most two cache lines per level and the
+ * height drops from log2(N) to logB(N) (about 6 levels instead of 24
+ * for 10^7 elements with B = 16).
+ *
+ * Same engine interface as `IterSegTree` (see segment_tree.cpp), and the
+ * same monoids: `query` and `query_batch` are const, `update_batch` and
+ * the constructor take an optional `threads`, so it drops into anything
+ * written against `IterSegTree` (e.g. `ConcurrentSegTree<WideSegTree<>>`).
+ * `B` is the layout knob: `WideSegTree<T, Monoid, B>`, or
+ * `SegTreeLayout<T, Monoid, B>`, which is the binary `IterSegTree` for
+ * B = 2, to benchmark both layouts by changing one number.
+ * Queries keep separate left and right accumulators, so non-commutative
+ * monoids are supported.
+ *
+ * Complexity:
+ * - Build: O(N)
+ * - Range Query: O(B * logB N), at most 2 cache lines per level
+ * - Point Update: O(B * logB N), 1 cache line per level
+ * - update_batch: every touched block is re-folded once per level
+ * - Space: about N * B / (B - 1)
+ *
+ */
+
+#ifndef CODEBOOK_WIDE_SEGMENT_TREE
+#define CODEBOOK_WIDE_SEGMENT_TREE
+#include "segment_tree.cpp"
+
+// Allocator handing out 64-byte aligned storage, so that a block of `B`
+// entries starting at a multiple of `B` never straddles two cache lines.
+template <typename T>
+struct CacheLineAllocator {
+    using value_type = T;
+    static constexpr std::align_val_t ALIGN{64};
+
+    CacheLineAllocator() = default;
+    template <typename U>
+    CacheLineAllocator(const CacheLineAllocator<U>&) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), ALIGN));
+    }
+    void deallocate(T* p, size_t) { ::operator delete(p, ALIGN); }
+
+    template <typename U>
+    bool operator==(const CacheLineAllocator<U>&) const { return true; }
+};
+
+template <typename T = long long, typename Monoid = SumMonoid<T>,
+          int B = std::max<int>(2, 64 / sizeof(T))>
+struct WideSegTree {
+    static_assert(B >= 2, "a node needs at least two children");
+
+    int n;
+    std::vector<T, CacheLineAllocator<T>> t; // all levels, leaves first
+    std::vector<int> offset;                 // start of each level in `t`
+
+    static T merge(const T& a, const T& b) { return Monoid{}(a, b); }
+
+    // Constructor to build from a vector (of `T`, or anything convertible to `T`)
+    template <typename U>
+    WideSegTree(const std::vector<U>& a, int threads = 1) {
+        n = a.size();
+        // Lay out the level sizes first: each level is padded to whole blocks.
+        int total = 0;
+        for (int len = std::max(n, 1);; len = (len + B - 1) / B) {
+            offset.push_back(total);
+            total += round_up(len);
+            if (len <= B) break;
+        }
+        t.assign(total, Monoid::identity());
+        parallel_chunks(threads, n, GRAIN, [&](int b, int e) {
+            for (int i = b; i < e; ++i) t[i] = static_cast<T>(a[i]);
+        });
+        // A level only reads the one below it, so its blocks are independent
+        for (int k = 1; k < (int)offset.size(); ++k) {
+            int blocks = (offset[k] - offset[k - 1]) / B;
+            parallel_chunks(threads, blocks, GRAIN / B, [&](int b, int e) {
+                for (int j = b; j < e; ++j) t[offset[k] + j] = fold_block(k - 1, j);
+            });
+        }
+    }
+
+    // --- Private Helper Functions (the "engine") ---
+private:
+    static constexpr int GRAIN = 1 << 14; // fewest items worth a thread
+
+    static int round_up(int len) { return (len + B - 1) / B * B; }
+
+    // Merge of the whole block `j` of level `k`: one cache line
+    T fold_block(int k, int j) const {
+        const T* p = &t[offset[k] + j * B];
+        T res = p[0];
+        for (int i = 1; i < B; ++i) res = merge(res, p[i]);
+        return res;
+    }
+
+    // Merge of entries [l, r] of level `k`, in order
+    T fold_range(int k, int l, int r) const {
+        const T* p = &t[offset[k]];
+        T res = Monoid::identity();
+        for (int i = l; i <= r; ++i) res = merge(res, p[i]);
+        return res;
+    }
+
+    // --- Public Functions (the "steering wheel") ---
+public:
+    // Query for a range [l, r]
+    T query(int l, int r) const {
+        T res_left = Monoid::identity(), res_right = Monoid::identity();
+        for (int k = 0; k < (int)offset.size() && l <= r; ++k) {
+            if (l / B == r / B) {
+                // Both borders in one block: finish here.
+                res_left = merge(res_left, fold_range(k, l, r));
+                break;
+            }
+            // Take the partial blocks at both borders, then continue with
+            // the whole blocks strictly between them on the next level.
+            res_left = merge(res_left, fold_range(k, l, (l / B + 1) * B - 1));
+            res_right = merge(fold_range(k, r / B * B, r), res_right);
+            l = l / B + 1;
+            r = r / B - 1;
+        }
+        return merge(res_left, res_right);
+    }
+
+    // Update a single position `pos` to `new_val`
+    void update(int pos, T new_val) {
+        t[pos] = new_val;
+        for (int k = 1; k < (int)offset.size(); ++k) {
+            pos /= B;
+            t[offset[k] + pos] = fold_block(k - 1, pos);
+        }
+    }
+
+    // Answer `queries[i]` ([l, r] inclusive) into `out[i]`
+    void query_batch(std::span<const std::pair<int, int>> queries, std::span<T> out) const {
+        std::vector<int> order(queries.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return queries[a] < queries[b];
+        });
+        for (size_t k = 0; k < order.size(); ++k) {
+            if (k + 1 < order.size()) {
+                // The leaf blocks of the next walk; the levels above are few and hot
+                auto [nl, nr] = queries[order[k + 1]];
+                __builtin_prefetch(&t[nl]);
+                __builtin_prefetch(&t[nr]);
+            }
+            auto [l, r] = queries[order[k]];
+            out[order[k]] = query(l, r);
+        }
+    }
+
+    // Apply point writes `updates[i] = {pos, new_val}` in order
+    void update_batch(std::span<const std::pair<int, T>> updates, int threads = 1) {
+        std::vector<int> level, next;
+        for (const auto& [pos, val] : updates) {
+            t[pos] = val;
+            level.push_back(pos / B);
+        }
+        // Climb one level per round; the blocks touched on a level are
+        // distinct entries of the next one, so they are re-folded in parallel
+        for (int k = 1; k < (int)offset.size(); ++k) {
+            std::sort(level.begin(), level.end());
+            level.erase(std::unique(level.begin(), level.end()), level.end());
+            parallel_chunks(threads, level.size(), GRAIN, [&](int b, int e) {
+                for (int i = b; i < e; ++i) t[offset[k] + level[i]] = fold_block(k - 1, level[i]);
+            });
+            next.clear();
+            for (int j : level) next.push_back(j / B);
+            level.swap(next);
+        }
+    }
+};
+
+// The layout as a template parameter: B = 2 is the binary `IterSegTree`,
+// anything larger the wide tree with B children per node
+template <typename T = long long, typename Monoid = SumMonoid<T>, int B = 2>
+using SegTreeLayout = std::conditional_t<B == 2, IterSegTree<T, Monoid>, WideSegTree<T, Monoid, B>>;
+
+// --- Example Usage ---
+// #include <iostream>
+// int main() {
+//     std::vector<int> initial_array = {1, 2, 3, 4, 5};
+//
+//      Default fan-out: one cache line per node (8 x long long)
+//     WideSegTree st(initial_array);
+//     std::cout << "Sum of [1, 3]: " << st.query(1, 3) << std::endl; // 9
+//     st.update(2, 10);
+//     std::cout << "Sum of [1, 3]: " << st.query(1, 3) << std::endl; // 16
+//
+//      Explicit layout: 16 children per node over int
+//     WideSegTree<int, MinMonoid<int>, 16> mn(initial_array);
+//     std::cout << "Min of [2, 4]: " << mn.query(2, 4) << std::endl; // 3
+//
+//      Same batched interface as IterSegTree; SegTreeLayout picks the layout
+//     SegTreeLayout<long long, SumMonoid<long long>, 8> wide(initial_array, 4);
+//     std::vector<std::pair<int, long long>> writes = {{0, 10}, {4, 20}};
+//     wide.update_batch(writes, 4); // {10, 2, 10, 4, 20}
+// }
+#endif // CODEBOOK_WIDE_SEGMENT_TREE
@@ -0,0 +1,135 @@
+/**
+ * =================================================================
+ * CSR Graph (Compressed Sparse Row adjacency)
+ * =================================================================
+ *
+ * Description:
+ * A static adjacency structure: all neighbour lists live back to back
+ * in one contiguous array, and `offset[v]..offset[v+1]` delimits the
+ * neighbours of `v`. Compared to `std::vector<std::vector<int>>` this is
+ * two allocations instead of one per node, and a neighbour scan is a
+ * sequential read with no pointer chasing.
+ *
+ * It is built once from an edge list with a counting sort (count the
+ * degrees, prefix-sum them into offsets, scatter the edges). Edges are
+ * scattered in input order, so every neighbour list has exactly the order
+ * `push_back` would have produced, and algorithms give identical results
+ * on both representations.
+ *
+ * A built graph can be written with `save(path)` and mapped back with
+ * `CSRGraph::load(path)` (io/binary_file.cpp): no edge list is parsed
+ * or re-sorted, and processes mapping the same file share its pages.
+ * The arrays are only viewed through spans, so they may live in either.
+ * Loading checks the whole file once (offsets non-decreasing and within
+ * the edge array, every neighbour a node id), so a corrupt file is
+ * rejected instead of read out of bounds later.
+ *
+ * Nodes are ids in [0, n]: 0-indexed graphs use [0, n), 1-indexed ones
+ * use [1, n] and slot 0 simply stays empty.
+ *
+ * Consumers:
+ * - `LCA::build(graph, root)`     (lca_binary_lifting.cpp)
+ * - `CycleDetector(graph, undirected)` (unified_graph_cycle_finder.cpp)
+ * - `HLD::build(graph, root)`     (heavy_light_decomposition.cpp)
+ *
+ * Complexity:
+ * - Build: O(V + E)
+ * - neighbors(v): O(1), a span into the contiguous array
+ * - load(path): O(V + E), one sequential validation pass over the mapping
+ * - Space: O(V + E)
+ *
+ */
+
+#ifndef CODEBOOK_CSR_GRAPH
+#define CODEBOOK_CSR_GRAPH
+#include <bits/stdc++.h>
+#include "../io/binary_file.cpp"
+
+struct CSRGraph {
+    int n;
+    std::span<const int> offset; // size n + 2, neighbours of v: [offset[v], offset[v + 1])
+    std::span<const int> adj;    // all neighbour lists, back to back
+    // Owns what 'offset' and 'adj' view: the arrays built by the constructor,
+    // or a file mapped by 'load'. Shared, so copies of a graph are cheap.
+    std::shared_ptr<const void> storage;
+
+    CSRGraph() : CSRGraph(0, {}) {}
+
+    // Build from an edge list. For undirected graphs each edge is stored both ways.
+    CSRGraph(int num_nodes, const std::vector<std::pair<int, int>>& edges, bool undirected = false)
+        : n(num_nodes) {
+        auto arrays = std::make_shared<std::array<std::vector<int>, 2>>();
+        auto& [off, to] = *arrays;
+        // 1. Degrees, shifted by one so the prefix sum lands on the start offsets
+        off.assign(n + 2, 0);
+        for (auto [u, v] : edges) {
+            ++off[u + 1];
+            if (undirected) ++off[v + 1];
+        }
+        // 2. Prefix sums: off[v] is where the neighbours of v begin
+        for (int v = 0; v <= n; ++v) off[v + 1] += off[v];
+        // 3. Scatter the edges in input order
+        to.resize(off[n + 1]);
+        std::vector<int> pos(off.begin(), off.end() - 1);
+        for (auto [u, v] : edges) {
+            to[pos[u]++] = v;
+            if (undirected) to[pos[v]++] = u;
+        }
+        offset = off, adj = to;
+        storage = std::move(arrays);
+    }
+
+    // Write the graph to 'path' (io/binary_file.cpp). Returns false on I/O errors.
+    bool save(const std::string& path) const {
+        int32_t meta[1] = {n};
+        return BinaryFile::save(path, FILE_MAGIC, FILE_VERSION, {meta, offset, adj});
+    }
+
+    // Map a graph written by 'save', zero-copy. std::nullopt if the file is
+    // missing, truncated, of another version or inconsistent.
+    static std::optional<CSRGraph> load(const std::string& path) {
+        auto file = BinaryFile::open(path, FILE_MAGIC, FILE_VERSION, 3);
+        if (!file || file->sections[0].size() != 1) return std::nullopt;
+        int n = file->sections[0][0];
+        auto off = file->sections[1], to = file->sections[2];
+        if (n < 0 || off.size() != (size_t)n + 2 || off[0] != 0 || (size_t)off[n + 1] != to.size()) {
+            return std::nullopt;
+        }
+        for (int v = 0; v <= n; ++v) {
+            if (off[v] > off[v + 1]) return std::nullopt; // with off[n + 1], all within 'to'
+        }
+        for (int u : to) {
+            if (u < 0 || u > n) return std::nullopt;
+        }
+        CSRGraph g;
+        g.n = n, g.offset = off, g.adj = to;
+        g.storage = file->storage;
+        return g;
+    }
+
+    std::span<const int> neighbors(int v) const {
+        return {adj.data() + offset[v], adj.data() + offset[v + 1]};
+    }
+
+    int degree(int v) const {
+        return offset[v + 1] - offset[v];
+    }
+
+    int num_edges() const {
+        return adj.size();
+    }
+
+private:
+    static constexpr const char* FILE_MAGIC = "CBCSR";
+    static constexpr uint32_t FILE_VERSION = 1;
+};
+
+// --- Example Usage ---
+// int main() {
+//     // Path 1 - 2 - 3 plus the chord 1 - 3, 1-indexed
+//     std::vector<std::pair<int, int>> edges = {{1, 2}, {2, 3}, {1, 3}};
+//     CSRGraph g(3, edges, true);
+//     for (int v : g.neighbors(1)) std::cout << v << " "; // 2 3
+//     std::cout << std::endl;
+// }
+#endif // CODEBOOK_CSR_GRAPH
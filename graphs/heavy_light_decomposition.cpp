@@ -0,0 +1,247 @@
+/**
+ * =====================================================================================
+ * Algorithm:   Heavy-Light Decomposition (HLD) + Segment Tree over the heavy paths
+ * Description: Splits a rooted tree into vertical "heavy paths" laid out contiguously
+ * in one array, so any u-v path is O(log N) contiguous ranges of that array. Backed by
+ * a segment tree this gives path queries and path updates on a tree that changes.
+ * =====================================================================================
+ * * Time Complexity:
+ * - Preprocessing: O(N)
+ * - lca(u, v):                  O(log N), no table at all
+ * - path_query / path_apply:    O(log^2 N) (O(log N) ranges, one tree operation each)
+ * - subtree_query / subtree_apply, update: O(log N)
+ * * Space Complexity: O(N) for the decomposition (vs. O(N log N) for the 'up' table of
+ * lca_binary_lifting.cpp), plus the segment tree.
+ * * =====================================================================================
+ * * How it works:
+ * 1. Heavy child: the child with the largest subtree. Every other child is "light",
+ * and each light edge on the way up at least doubles the subtree size, so a path to
+ * the root crosses at most log2(N) light edges.
+ * 2. Layout: a DFS that enters the heavy child first gives each heavy path a run of
+ * consecutive positions starting at its 'head', and each subtree the range
+ * [pos[v], pos[v] + size[v]). Nodes on one path are neighbours in memory too.
+ * 3. Path u-v: while u and v are on different heavy paths, take the deeper head's
+ * range [pos[head], pos[u]] and jump to the head's parent; the last range is between
+ * u and v on the shared path, whose upper end is the LCA.
+ * * Preprocessing is iterative (BFS for parents and sizes, an explicit stack for the
+ * layout), so path-like trees of depth 10^6+ are fine.
+ * * =====================================================================================
+ * * How to Use:
+ * - `HLD hld(n);`, 'add_edge(u, v)' for the n-1 edges, then 'hld.build(root)'.
+ * As with `LCA`, 'build(graph, root)' takes a `CSRGraph` (both directions) and
+ * 'build(edges, root)' the edge list. Nodes are 1-indexed.
+ * - `hld.lca(u, v)`, `hld.for_each_range(u, v, f)`: the bare decomposition;
+ * f(l, r) gets inclusive position ranges.
+ * - `HLDSegTree<T, Monoid, Tree> st(hld, values);` with 'values[v]' for node v:
+ * - `st.path_query(u, v)`:        Monoid over the nodes of the u-v path.
+ * - `st.path_apply(u, v, f)`:     Apply a lazy action to them (Tree = LazySegTree).
+ * - `st.subtree_query(v)`, `st.subtree_apply(v, f)`, `st.update(v, val)`.
+ * * Values on edges instead of nodes: store each edge's value on its child, build
+ * with 'EDGES = true', and the LCA (whose value belongs to the edge above it) is
+ * left out of every path.
+ * * Path ranges are combined in no particular order, so the monoid must be
+ * commutative (sum, min, max, gcd, xor, ...).
+ * =====================================================================================
+ */
+
+#ifndef CODEBOOK_HEAVY_LIGHT_DECOMPOSITION
+#define CODEBOOK_HEAVY_LIGHT_DECOMPOSITION
+#include "csr_graph.cpp"
+#include "../data_structures/lazy_segment_tree.cpp"
+
+struct HLD {
+    int n;
+    std::vector<std::vector<int>> adj;
+    std::vector<int> parent, depth, heavy, head, pos, size;
+
+    HLD(int num_nodes) : n(num_nodes) {
+        adj.resize(n + 1); // 1-indexed
+    }
+
+    void add_edge(int u, int v) {
+        adj[u].push_back(v);
+        adj[v].push_back(u);
+    }
+
+    // Preprocessing: the parent of the root is the root itself
+    void build(int root = 1) {
+        build_from(root, [&](int node) -> const std::vector<int>& { return adj[node]; });
+    }
+
+    // Preprocessing straight from a CSR adjacency
+    void build(const CSRGraph& graph, int root = 1) {
+        build_from(root, [&](int node) { return graph.neighbors(node); });
+    }
+
+    // Preprocessing from the whole list of n-1 edges, through a temporary CSRGraph
+    void build(const std::vector<std::pair<int, int>>& edges, int root = 1) {
+        build(CSRGraph(n, edges, true), root);
+    }
+
+    int lca(int u, int v) const {
+        while (head[u] != head[v]) {
+            if (depth[head[u]] < depth[head[v]]) {
+                std::swap(u, v);
+            }
+            u = parent[head[u]];
+        }
+        return depth[u] < depth[v] ? u : v;
+    }
+
+    // Call f(l, r) for the O(log N) inclusive position ranges covering the u-v path.
+    // With 'skip_lca' the position of the LCA is left out (values on edges).
+    template <typename F>
+    void for_each_range(int u, int v, F&& f, bool skip_lca = false) const {
+        while (head[u] != head[v]) {
+            if (depth[head[u]] < depth[head[v]]) {
+                std::swap(u, v);
+            }
+            f(pos[head[u]], pos[u]);
+            u = parent[head[u]];
+        }
+        if (depth[u] > depth[v]) {
+            std::swap(u, v);
+        }
+        // u is the LCA now
+        if (pos[u] + skip_lca <= pos[v]) {
+            f(pos[u] + skip_lca, pos[v]);
+        }
+    }
+
+private:
+    // 'neighbors(node)' returns any iterable range of the neighbours of 'node'
+    template <typename Neighbors>
+    void build_from(int root, Neighbors&& neighbors) {
+        parent.assign(n + 1, root);
+        depth.assign(n + 1, 0);
+        heavy.assign(n + 1, -1);
+        head.assign(n + 1, root);
+        pos.assign(n + 1, 0);
+        size.assign(n + 1, 1);
+
+        // 1. BFS for parents and depths; the vector doubles as the queue
+        std::vector<int> order;
+        order.reserve(n);
+        std::vector<char> seen(n + 1, 0);
+        order.push_back(root);
+        seen[root] = 1;
+        for (size_t head_idx = 0; head_idx < order.size(); ++head_idx) {
+            int node = order[head_idx];
+            for (int child : neighbors(node)) {
+                if (!seen[child]) {
+                    seen[child] = 1;
+                    parent[child] = node;
+                    depth[child] = depth[node] + 1;
+                    order.push_back(child);
+                }
+            }
+        }
+
+        // 2. Subtree sizes and heavy children, children before parents
+        for (size_t i = order.size(); i-- > 1;) {
+            int node = order[i], p = parent[node];
+            size[p] += size[node];
+            if (heavy[p] == -1 || size[node] > size[heavy[p]]) {
+                heavy[p] = node;
+            }
+        }
+
+        // 3. Preorder with the heavy child popped first, so it takes the next position
+        std::vector<int> stack = {root};
+        int next = 0;
+        while (!stack.empty()) {
+            int node = stack.back();
+            stack.pop_back();
+            pos[node] = next++;
+            head[node] = node != root && heavy[parent[node]] == node ? head[parent[node]] : node;
+            for (int child : neighbors(node)) {
+                if (child != parent[node] && child != heavy[node] && child != root) {
+                    stack.push_back(child);
+                }
+            }
+            if (heavy[node] != -1) {
+                stack.push_back(heavy[node]);
+            }
+        }
+    }
+};
+
+template <typename T = long long, typename Monoid = SumMonoid<T>,
+          typename Tree = LazySegTree<T, Monoid>, bool EDGES = false>
+struct HLDSegTree {
+    HLD hld;
+    Tree tree; // over positions: tree[hld.pos[v]] holds the value of node v
+
+    static T merge(const T& a, const T& b) { return Monoid{}(a, b); }
+
+    // 'values[v]' is the value of node v (for EDGES: of the edge above v)
+    template <typename U>
+    HLDSegTree(HLD decomposition, const std::vector<U>& values)
+        : hld(std::move(decomposition)), tree(by_position(hld, values)) {}
+
+    // Monoid over the u-v path
+    T path_query(int u, int v) const {
+        T res = Monoid::identity();
+        hld.for_each_range(u, v, [&](int l, int r) { res = merge(res, tree.query(l, r)); }, EDGES);
+        return res;
+    }
+
+    // Apply the lazy action 'f' to every value on the u-v path
+    template <typename F>
+    void path_apply(int u, int v, const F& f) {
+        hld.for_each_range(u, v, [&](int l, int r) { tree.apply(l, r, f); }, EDGES);
+    }
+
+    // Monoid over the subtree of v (for EDGES: the edges below v)
+    T subtree_query(int v) const {
+        int l = hld.pos[v] + EDGES, r = hld.pos[v] + hld.size[v] - 1;
+        return l <= r ? tree.query(l, r) : Monoid::identity();
+    }
+
+    template <typename F>
+    void subtree_apply(int v, const F& f) {
+        int l = hld.pos[v] + EDGES, r = hld.pos[v] + hld.size[v] - 1;
+        if (l <= r) {
+            tree.apply(l, r, f);
+        }
+    }
+
+    // Set the value of node v (for EDGES: of the edge above v)
+    void update(int v, T new_val) {
+        tree.update(hld.pos[v], new_val);
+    }
+
+    int lca(int u, int v) const {
+        return hld.lca(u, v);
+    }
+
+private:
+    // Permute node values into the heavy-path layout (position 0 upwards)
+    template <typename U>
+    static std::vector<T> by_position(const HLD& hld, const std::vector<U>& values) {
+        std::vector<T> a(hld.n, Monoid::identity());
+        for (int v = 1; v <= hld.n; ++v) {
+            a[hld.pos[v]] = static_cast<T>(values[v]);
+        }
+        return a;
+    }
+};
+
+// --- Example Usage ---
+// int main() {
+//     // 1 - 2 - 3, 2 - 4; node values 5, 1, 7, 2
+//     HLD hld(4);
+//     hld.build({{1, 2}, {2, 3}, {2, 4}}, 1);
+//     std::vector<long long> values = {0, 5, 1, 7, 2};
+//     HLDSegTree st(hld, values); // path sums, path adds
+//     std::cout << st.path_query(3, 4) << std::endl; // 7 + 1 + 2 = 10
+//     st.path_apply(1, 3, 10LL);                    // 15, 11, 17, 2
+//     std::cout << st.subtree_query(2) << std::endl; // 11 + 17 + 2 = 30
+//     std::cout << st.lca(3, 4) << std::endl;        // 2
+//
+//     // Heaviest edge on a path: edge weights stored on the child node
+//     using Max = MaxMonoid<long long>;
+//     HLDSegTree<long long, Max, SegTree<long long, Max>, true> heaviest(hld, values);
+//     std::cout << heaviest.path_query(3, 4) << std::endl; // max(7, 2) = 7
+// }
+#endif // CODEBOOK_HEAVY_LIGHT_DECOMPOSITION
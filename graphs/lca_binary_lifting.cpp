@@ -5,116 +5,428 @@
  * Binary lifting precomputes 2^i-th ancestors for each node.
  * =====================================================================================
  * * Time Complexity:
- * - Preprocessing (DFS): O(N * log N)
+ * - Preprocessing (BFS + table fill): O(N * log N)
  * - Per Query (lca):    O(log N)
  * * Space Complexity: O(N * log N) for the 'up' table.
  * * =====================================================================================
  * * Prerequisites:
- * 1. An adjacency list 'adj' representing the tree.
- * 2. Global constants MAXN and LOGN must be set appropriately.
- * 3. Resize 'adj' and 'depth' vectors to N+1.
- * 4. Call the preprocessing function 'dfs(root, root)' once before any lca queries.
- * The parent of the root should be the root itself.
+ * 1. Create the structure with the real number of nodes: `LCA tree(n);`. Every table
+ * is sized from n (LOG = bit_width(n)), so there is no compile-time limit and any
+ * number of independent trees can live in one process.
+ * 2. Add the n-1 tree edges with 'add_edge(u, v)'. Nodes are 1-indexed.
+ * 3. Call 'build(root)' once before any lca queries ('build(root, threads)' on many cores).
+ * Alternatively, skip 'add_edge' and call 'build(graph, root)' with a `CSRGraph`
+ * (csr_graph.cpp) holding the tree in both directions, or 'build(edges, root)' with
+ * the edge list itself. Both avoid growing a vector per node while loading.
+ * 4. Optionally 'save(path)' the built tables; later, 'LCA::load(path)' maps them
+ * back zero-copy (io/binary_file.cpp), so a restart skips the build entirely and
+ * processes loading the same file share its pages. Loading reads the table once to
+ * check every depth and ancestor id is in [0, n], so a corrupt file is rejected
+ * rather than read out of bounds by the queries.
+ * * =====================================================================================
+ * * Preprocessing is iterative: a BFS from the root assigns parents and depths (no
+ * recursion, so path-like trees of depth 10^6+ are fine), then the 'up' table is filled
+ * one level at a time. Level i only reads level i-1, so each pass streams through two
+ * rows instead of hopping between random rows of the table for every node.
+ * 'build(root, threads)' runs both phases on several cores: the BFS goes one depth
+ * at a time with each frontier split into chunks, and every table level is a
+ * parallel loop over the nodes. Tiny frontiers (e.g. a path) stay serial.
  * * =====================================================================================
  * * Functions:
- * - dfs(node, parent):   Performs DFS from the root to compute depths and the 'up' table.
+ * - build(root):         Computes depths and the 'up' table from the root.
+ * - build(graph, root):  Same, reading the tree from a CSRGraph.
+ * - build(edges, root):  Same, from the edge list (through a temporary CSRGraph).
  * - lca(u, v):           Returns the LCA of nodes u and v.
+ * - kth_ancestor(u, k):  The ancestor k edges above u (-1 if u is less than k deep).
+ * - dist(u, v):          Number of edges on the path between u and v.
+ * - save(path), load(path): Write the tables to / map them from a binary file.
+ * * Thread safety: after build (or load) the tables are never written again, and
+ * lca() is `const`, so any number of threads may query one instance (or copies of
+ * it, which share the tables) at the same time without locking.
+ * * =====================================================================================
+ * * Weighted Paths (`WeightedLCA<T, Monoid>`):
+ * For path aggregates (heaviest edge on the u-v path, weighted distance, ...) over
+ * one table instead of a second parallel lifting table. Edges carry a weight
+ * ('add_edge(u, v, w)'), and every table entry is a {2^i-th ancestor, aggregate of
+ * the 2^i edges up to it} pair, so each jump loads the ancestor and its aggregate
+ * from the same cache line. Monoids are those of segment_tree.cpp (MaxMonoid by
+ * default); they must be commutative, since the v side of a path is combined
+ * bottom up as well.
+ * - lca(u, v), kth_ancestor(u, k): As above.
+ * - path_query(u, v):    Monoid over the edges of the u-v path, found in the same
+ * pass as the LCA ('identity()' when u == v).
+ * - dist(u, v):          Sum of the edge weights on the u-v path.
+ * * Space: O(N * log N) {int, T} pairs.
  * * =====================================================================================
  */
 
-#include <bits/stdc++.h>
+// Include guard instead of `#pragma once`: this file is also a main file.
+#ifndef CODEBOOK_LCA_BINARY_LIFTING
+#define CODEBOOK_LCA_BINARY_LIFTING
+#include "csr_graph.cpp"
+#include "../io/fast_io.cpp"
+#include "../io/binary_file.cpp"
+#include "../utils/parallel_chunks.cpp"
+#include "../data_structures/segment_tree.cpp"
+
+struct LCA {
+    int n, LOG;
+    std::vector<std::vector<int>> adj;
+    std::vector<const int*> up; // up[i][node] is the 2^i-th ancestor of 'node'
+    const int* depth = nullptr;
+    // Owns the rows 'up' and 'depth' point into: one flat (LOG + 1) x (n + 1)
+    // table, depth first, built by 'build' or mapped from a file by 'load'.
+    // Shared, so copies of a built LCA reuse the same immutable table.
+    std::shared_ptr<const void> tables;
+
+    LCA(int num_nodes)
+        : n(num_nodes), LOG(std::max(1, (int)std::bit_width((unsigned)num_nodes))) {
+        adj.resize(n + 1); // 1-indexed
+    }
+
+    void add_edge(int u, int v) {
+        adj[u].push_back(v);
+        adj[v].push_back(u);
+    }
 
-// Set constants based on problem constraints
-const int MAXN = 200001;
-const int LOGN = 18; // ceil(log2(MAXN)) is a safe value
+    // Preprocessing: the parent of the root is the root itself.
+    // 'threads' > 1 runs the BFS levels and the table fill on that many threads.
+    void build(int root = 1, int threads = 1) {
+        build_from(root, threads, [&](int node) -> const std::vector<int>& { return adj[node]; });
+    }
 
-std::vector<int> adj[MAXN];
-int up[MAXN][LOGN];
-int depth[MAXN];
+    // Preprocessing straight from a CSR adjacency
+    void build(const CSRGraph& graph, int root = 1, int threads = 1) {
+        build_from(root, threads, [&](int node) { return graph.neighbors(node); });
+    }
 
-// Preprocessing function to compute depth and build the 'up' table
-void dfs(int node, int par, int d = 0) {
-    depth[node] = d;
-    up[node][0] = par;
+    // Preprocessing from the whole list of n-1 edges, without 'add_edge': the
+    // adjacency is one temporary CSRGraph, freed as soon as the tables are built
+    void build(const std::vector<std::pair<int, int>>& edges, int root = 1, int threads = 1) {
+        build(CSRGraph(n, edges, true), root, threads);
+    }
 
-    // Dynamic Programming to build the binary lifting table
-    // up[node][i] is the 2^i-th ancestor of 'node'
-    for (int i = 1; i < LOGN; ++i) {
-        up[node][i] = up[up[node][i - 1]][i - 1];
+    // Write the built tables to 'path' (io/binary_file.cpp). Returns false on I/O errors.
+    bool save(const std::string& path) const {
+        int32_t meta[2] = {n, LOG};
+        return BinaryFile::save(path, FILE_MAGIC, FILE_VERSION,
+                                {meta, {depth, (size_t)(LOG + 1) * (n + 1)}});
     }
 
-    for (int child : adj[node]) {
-        if (child != par) {
-            dfs(child, node, d + 1);
+    // Map tables written by 'save': ready for lca() at once, nothing is rebuilt.
+    // std::nullopt if the file is missing, truncated, of another version, or holds
+    // a depth or ancestor outside [0, n] (one sequential pass over the table).
+    static std::optional<LCA> load(const std::string& path) {
+        auto file = BinaryFile::open(path, FILE_MAGIC, FILE_VERSION, 2);
+        if (!file || file->sections[0].size() != 2) return std::nullopt;
+        int n = file->sections[0][0], LOG = file->sections[0][1];
+        if (n < 0 || LOG != std::max(1, (int)std::bit_width((unsigned)n)) ||
+            file->sections[1].size() != (size_t)(LOG + 1) * (n + 1)) {
+            return std::nullopt;
         }
+        for (int x : file->sections[1]) {
+            if (x < 0 || x > n) return std::nullopt;
+        }
+        LCA tree(0);
+        tree.n = n, tree.LOG = LOG;
+        tree.adopt(file->storage, file->sections[1].data());
+        return tree;
     }
-}
 
-// Function to find the LCA of nodes u and v
-int lca(int u, int v) {
-    // Ensure u is the deeper node
-    if (depth[u] < depth[v]) {
-        std::swap(u, v);
+private:
+    static constexpr const char* FILE_MAGIC = "CBLCA";
+    static constexpr uint32_t FILE_VERSION = 1;
+    static constexpr int GRAIN = 1 << 15; // fewest nodes worth a thread
+
+    // 'neighbors(node)' returns any iterable range of the neighbours of 'node'
+    template <typename Neighbors>
+    void build_from(int root, int threads, Neighbors&& neighbors) {
+        size_t row = n + 1;
+        // Every entry is written below: no serial zero-fill of the whole table
+        auto table = std::make_shared_for_overwrite<int[]>((LOG + 1) * row);
+        auto level = [&](int i) { return table.get() + (i + 1) * row; };
+        int* depth_row = table.get();
+        int* parent = level(0);
+        parallel_chunks(threads, row, GRAIN, [&](int b, int e) {
+            std::fill(depth_row + b, depth_row + e, 0);
+            std::fill(parent + b, parent + e, root); // unreached nodes hang off the root
+        });
+
+        if (threads <= 1) {
+            // BFS from the root; the vector doubles as the queue
+            std::vector<int> order;
+            order.reserve(n);
+            std::vector<char> seen(n + 1, 0);
+            order.push_back(root);
+            seen[root] = 1;
+            for (size_t head = 0; head < order.size(); ++head) {
+                int node = order[head];
+                for (int child : neighbors(node)) {
+                    if (!seen[child]) {
+                        seen[child] = 1;
+                        parent[child] = node;
+                        depth_row[child] = depth_row[node] + 1;
+                        order.push_back(child);
+                    }
+                }
+            }
+        } else {
+            // Level-synchronous BFS, each level split across the threads. In a
+            // tree a node is only reached from its parent, so no entry is ever
+            // written twice and 'child != parent[node]' replaces 'seen'.
+            std::vector<int> frontier = {root}, next;
+            std::mutex next_lock;
+            while (!frontier.empty()) {
+                next.clear();
+                parallel_chunks(threads, frontier.size(), GRAIN, [&](int b, int e) {
+                    std::vector<int> found;
+                    for (int i = b; i < e; ++i) {
+                        int node = frontier[i];
+                        for (int child : neighbors(node)) {
+                            if (child != parent[node] && child != root) {
+                                parent[child] = node;
+                                depth_row[child] = depth_row[node] + 1;
+                                found.push_back(child);
+                            }
+                        }
+                    }
+                    std::lock_guard<std::mutex> guard(next_lock);
+                    next.insert(next.end(), found.begin(), found.end());
+                });
+                frontier.swap(next);
+            }
+        }
+
+        // Dynamic Programming to build the binary lifting table, level by level.
+        // A level only reads the one before it, so its nodes are independent.
+        for (int i = 1; i < LOG; ++i) {
+            const int* prev = level(i - 1);
+            int* cur = level(i);
+            cur[0] = root;
+            parallel_chunks(threads, n, GRAIN, [&](int b, int e) {
+                for (int node = b + 1; node <= e; ++node) {
+                    cur[node] = prev[prev[node]];
+                }
+            });
+        }
+        const int* data = table.get();
+        adopt(std::move(table), data);
+    }
+
+    // Point 'up' and 'depth' into a flat table starting at 'data'
+    void adopt(std::shared_ptr<const void> owner, const int* data) {
+        tables = std::move(owner);
+        depth = data;
+        up.resize(LOG);
+        for (int i = 0; i < LOG; ++i) up[i] = data + (size_t)(i + 1) * (n + 1);
     }
 
-    // 1. Bring u to the same depth as v
-    // We jump u up by 2^i steps until it's at the same level as v
-    for (int i = LOGN - 1; i >= 0; --i) {
-        if (depth[u] - (1 << i) >= depth[v]) {
-            u = up[u][i];
+public:
+    // Function to find the LCA of nodes u and v
+    int lca(int u, int v) const {
+        // Ensure u is the deeper node
+        if (depth[u] < depth[v]) {
+            std::swap(u, v);
+        }
+
+        // 1. Bring u to the same depth as v
+        // We jump u up by 2^i steps until it's at the same level as v
+        for (int i = LOG - 1; i >= 0; --i) {
+            if (depth[u] - (1 << i) >= depth[v]) {
+                u = up[i][u];
+            }
+        }
+
+        // If v was an ancestor of u, then u is now v
+        if (u == v) {
+            return u;
+        }
+
+        // 2. Lift u and v simultaneously until their parents are the same
+        // We are looking for the highest ancestors of u and v that are NOT the same.
+        for (int i = LOG - 1; i >= 0; --i) {
+            if (up[i][u] != up[i][v]) {
+                u = up[i][u];
+                v = up[i][v];
+            }
         }
+
+        // The LCA is the direct parent of the final u and v.
+        return up[0][u];
     }
 
-    // If v was an ancestor of u, then u is now v
-    if (u == v) {
+    // The ancestor 'k' edges above 'u', or -1 if 'u' is less than 'k' deep
+    int kth_ancestor(int u, int k) const {
+        if (k < 0 || k > depth[u]) {
+            return -1;
+        }
+        for (int i = 0; k > 0; ++i, k >>= 1) {
+            if (k & 1) {
+                u = up[i][u];
+            }
+        }
         return u;
     }
 
-    // 2. Lift u and v simultaneously until their parents are the same
-    // We are looking for the highest ancestors of u and v that are NOT the same.
-    for (int i = LOGN - 1; i >= 0; --i) {
-        if (up[u][i] != up[v][i]) {
-            u = up[u][i];
-            v = up[v][i];
+    // Number of edges on the path between u and v
+    int dist(int u, int v) const {
+        return depth[u] + depth[v] - 2 * depth[lca(u, v)];
+    }
+};
+
+template <typename T = long long, typename Monoid = MaxMonoid<T>>
+struct WeightedLCA {
+    // The 2^i-th ancestor of a node and the aggregate of the 2^i edges up to it
+    struct Jump {
+        int to;
+        T agg;
+    };
+
+    int n, LOG;
+    std::vector<std::vector<std::pair<int, T>>> adj;
+    std::vector<Jump> jump;  // level i of 'node' at jump[i * (n + 1) + node]
+    std::vector<int> depth;
+    std::vector<T> root_dist; // sum of the edge weights from the root
+
+    static T merge(const T& a, const T& b) { return Monoid{}(a, b); }
+
+    WeightedLCA(int num_nodes)
+        : n(num_nodes), LOG(std::max(1, (int)std::bit_width((unsigned)num_nodes))) {
+        adj.resize(n + 1); // 1-indexed
+    }
+
+    void add_edge(int u, int v, T w) {
+        adj[u].push_back({v, w});
+        adj[v].push_back({u, w});
+    }
+
+    // Preprocessing: the root jumps to itself over 'identity()'
+    void build(int root = 1) {
+        size_t row = n + 1;
+        jump.assign(LOG * row, {root, Monoid::identity()});
+        depth.assign(row, 0);
+        root_dist.assign(row, T{});
+
+        // BFS from the root; the vector doubles as the queue
+        std::vector<int> order;
+        order.reserve(n);
+        std::vector<char> seen(row, 0);
+        order.push_back(root);
+        seen[root] = 1;
+        for (size_t head = 0; head < order.size(); ++head) {
+            int node = order[head];
+            for (auto [child, w] : adj[node]) {
+                if (!seen[child]) {
+                    seen[child] = 1;
+                    jump[child] = {node, w};
+                    depth[child] = depth[node] + 1;
+                    root_dist[child] = root_dist[node] + w;
+                    order.push_back(child);
+                }
+            }
+        }
+
+        // Level by level, as in LCA: 2^i edges are two runs of 2^(i-1)
+        for (int i = 1; i < LOG; ++i) {
+            const Jump* prev = &jump[(i - 1) * row];
+            Jump* cur = &jump[i * row];
+            for (size_t node = 0; node < row; ++node) {
+                const Jump& half = prev[node];
+                cur[node] = {prev[half.to].to, merge(half.agg, prev[half.to].agg)};
+            }
         }
     }
 
-    // The LCA is the direct parent of the final u and v.
-    return up[u][0];
-}
+    int lca(int u, int v) const {
+        return climb(u, v).first;
+    }
+
+    // Aggregate of the edge weights on the u-v path
+    T path_query(int u, int v) const {
+        return climb(u, v).second;
+    }
+
+    // Sum of the edge weights on the u-v path
+    T dist(int u, int v) const {
+        return root_dist[u] + root_dist[v] - 2 * root_dist[lca(u, v)];
+    }
+
+    // The ancestor 'k' edges above 'u', or -1 if 'u' is less than 'k' deep
+    int kth_ancestor(int u, int k) const {
+        if (k < 0 || k > depth[u]) {
+            return -1;
+        }
+        for (int i = 0; k > 0; ++i, k >>= 1) {
+            if (k & 1) {
+                u = at(i, u).to;
+            }
+        }
+        return u;
+    }
+
+private:
+    const Jump& at(int i, int node) const { return jump[(size_t)i * (n + 1) + node]; }
+
+    // The LCA of u and v and the aggregate of the path between them, in one pass
+    std::pair<int, T> climb(int u, int v) const {
+        T res = Monoid::identity();
+        if (depth[u] < depth[v]) {
+            std::swap(u, v);
+        }
+        for (int i = LOG - 1; i >= 0; --i) {
+            if (depth[u] - (1 << i) >= depth[v]) {
+                res = merge(res, at(i, u).agg);
+                u = at(i, u).to;
+            }
+        }
+        if (u == v) {
+            return {u, res};
+        }
+        for (int i = LOG - 1; i >= 0; --i) {
+            const Jump &ju = at(i, u), &jv = at(i, v);
+            if (ju.to != jv.to) {
+                res = merge(res, merge(ju.agg, jv.agg));
+                u = ju.to;
+                v = jv.to;
+            }
+        }
+        return {at(0, u).to, merge(res, merge(at(0, u).agg, at(0, v).agg))};
+    }
+};
 
 /**
  * =====================================================================================
  * How to Use:
  * =====================================================================================
  */
+// Compiled only when this file is built directly, so other files can include it.
+#if __INCLUDE_LEVEL__ == 0
 int main() {
-    // Fast I/O
-    std::ios_base::sync_with_stdio(false);
-    std::cin.tie(NULL);
+    // Fast I/O: mapped input, buffered output (io/fast_io.cpp)
+    FastInput in;
+    FastOutput out;
 
-    int n, q; // Number of nodes and queries
-    std::cin >> n >> q;
+    int n = in.read(), q = in.read(); // Number of nodes and queries
 
-    // Read tree edges (assuming 1-based indexing)
-    for (int i = 0; i < n - 1; ++i) {
-        int u, v;
-        std::cin >> u >> v;
-        adj[u].push_back(v);
-        adj[v].push_back(u);
+    LCA tree(n);
+
+    // Read tree edges (assuming 1-based indexing) into one flat list
+    std::vector<std::pair<int, int>> edges(std::max(0, n - 1));
+    for (auto& [u, v] : edges) {
+        u = in.read(), v = in.read();
     }
 
     // --- Preprocessing Step ---
-    // Call DFS from the root. Let's assume root is 1.
-    // The parent of the root is the root itself.
-    dfs(1, 1);
+    // Build from the root. Let's assume root is 1.
+    tree.build(edges, 1);
 
     // --- Process Queries ---
     for (int i = 0; i < q; ++i) {
-        int u, v;
-        std::cin >> u >> v;
-        std::cout << lca(u, v) << "\n";
+        int u = in.read(), v = in.read();
+        out.write(tree.lca(u, v));
     }
 
     return 0;
-}
\ No newline at end of file
+}
+#endif
+#endif // CODEBOOK_LCA_BINARY_LIFTING
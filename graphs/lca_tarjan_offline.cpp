@@ -0,0 +1,123 @@
+/*
+ * =====================================================================================
+ * Algorithm:   Offline Lowest Common Ancestor (Tarjan's Algorithm)
+ * Description: Answers a whole batch of LCA queries, known up front, in a single
+ * DFS over the tree using a Disjoint Set Union (`DSU` from dsu.cpp).
+ * =====================================================================================
+ * * Time Complexity: O((N + Q) * α(N)) for the whole batch.
+ * * Space Complexity: O(N + Q). There is no N * log N 'up' table.
+ * * =====================================================================================
+ * * Idea:
+ * During the DFS, every finished subtree is merged into its parent's set, and the set
+ * remembers its topmost node still on the DFS path ('ancestor'). When node v finishes,
+ * for every query (v, w) whose w is already finished, the answer is the 'ancestor' of
+ * w's set: the deepest node on the current path whose subtree contains w.
+ * The DFS uses an explicit stack, so path-like trees are fine.
+ * * =====================================================================================
+ * * Same tree input API as `LCA` in lca_binary_lifting.cpp:
+ * 1. `OfflineLCA tree(n);`, then the n-1 edges with 'add_edge(u, v)'. 1-indexed.
+ * 2. 'solve(queries, root)' returns the answers, in the order of 'queries'.
+ * * =====================================================================================
+ */
+
+// Include guard instead of `#pragma once`: this file is also a main file.
+#ifndef CODEBOOK_LCA_TARJAN_OFFLINE
+#define CODEBOOK_LCA_TARJAN_OFFLINE
+#include "../data_structures/dsu.cpp"
+#include "../io/fast_io.cpp"
+
+struct OfflineLCA {
+    int n;
+    std::vector<std::vector<int>> adj;
+
+    OfflineLCA(int num_nodes) : n(num_nodes) {
+        adj.resize(n + 1); // 1-indexed
+    }
+
+    void add_edge(int u, int v) {
+        adj[u].push_back(v);
+        adj[v].push_back(u);
+    }
+
+    std::vector<int> solve(const std::vector<std::pair<int, int>>& queries, int root = 1) {
+        // Queries grouped by endpoint: (other endpoint, query index)
+        std::vector<std::vector<std::pair<int, int>>> at(n + 1);
+        for (int i = 0; i < (int)queries.size(); ++i) {
+            auto [u, v] = queries[i];
+            at[u].push_back({v, i});
+            at[v].push_back({u, i});
+        }
+
+        std::vector<int> answers(queries.size());
+        DSU<true> dsu(n + 1); // iterative find_set: no recursion on deep trees
+        std::vector<int> ancestor(n + 1);
+        std::vector<char> done(n + 1, 0);
+
+        // Explicit DFS stack of {node, parent, next neighbour index}
+        std::vector<std::array<int, 3>> stack = {{root, 0, 0}};
+        ancestor[root] = root;
+        while (!stack.empty()) {
+            auto& [node, par, next] = stack.back();
+            if (next < (int)adj[node].size()) {
+                int child = adj[node][next++];
+                if (child != par) {
+                    ancestor[child] = child;
+                    stack.push_back({child, node, 0});
+                }
+                continue;
+            }
+
+            // 'node' is finished: answer its queries, then merge it into its parent
+            done[node] = 1;
+            for (auto [other, idx] : at[node]) {
+                if (done[other]) {
+                    answers[idx] = ancestor[dsu.find_set(other)];
+                }
+            }
+            int finished = node, up = par;
+            stack.pop_back();
+            if (up != 0) {
+                dsu.union_sets(up, finished);
+                ancestor[dsu.find_set(up)] = up;
+            }
+        }
+        return answers;
+    }
+};
+
+/**
+ * =====================================================================================
+ * How to Use:
+ * =====================================================================================
+ */
+// Compiled only when this file is built directly, so other files can include it.
+#if __INCLUDE_LEVEL__ == 0
+int main() {
+    // Fast I/O: mapped input, buffered output (io/fast_io.cpp)
+    FastInput in;
+    FastOutput out;
+
+    int n = in.read(), q = in.read(); // Number of nodes and queries
+
+    OfflineLCA tree(n);
+
+    // Read tree edges (assuming 1-based indexing)
+    for (int i = 0; i < n - 1; ++i) {
+        int u = in.read(), v = in.read();
+        tree.add_edge(u, v);
+    }
+
+    // Read every query first, then answer them all at once. Root is 1.
+    std::vector<std::pair<int, int>> queries(q);
+    for (auto& [u, v] : queries) {
+        u = in.read(), v = in.read();
+    }
+
+    for (int answer : tree.solve(queries, 1)) {
+        out.write(answer);
+    }
+
+    return 0;
+}
+#endif
+#endif // CODEBOOK_LCA_TARJAN_OFFLINE
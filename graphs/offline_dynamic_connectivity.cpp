@@ -0,0 +1,134 @@
+/*
+ * =====================================================================================
+ * Algorithm:   Offline Dynamic Connectivity (Segment Tree over Time)
+ * Description: Answers "are u and v connected right now?" over a log of edge
+ * insertions and deletions, when the whole log is known in advance.
+ * =====================================================================================
+ * * Idea:
+ * 1. Every edge is alive during one time interval [added, removed). Each operation
+ * in the log is one time step.
+ * 2. The interval is split into the O(log Q) canonical nodes of a segment tree over
+ * time (`SegTree<>::decompose`, see segment_tree.cpp) and the edge is stored there.
+ * 3. A DFS over the time tree unions the edges of a node on entry and rolls them back
+ * on exit (`RollbackDSU`, see rollback_dsu.cpp). At leaf t the DSU holds exactly the
+ * edges alive at time t, so query t is a single same_set call.
+ * * =====================================================================================
+ * * Time Complexity: O((N + Q) log Q log N)
+ * - every edge lives in O(log Q) nodes, and each union / find costs O(log N).
+ * * Space Complexity: O(N + Q log Q)
+ * * =====================================================================================
+ * * Functions:
+ * - add_edge(u, v):      Inserts edge u-v at the current time (parallel edges allowed).
+ * - remove_edge(u, v):   Deletes one copy of edge u-v at the current time. Removing an
+ * edge that is not alive (never added, or every copy already removed) does nothing.
+ * - query(u, v):         Asks whether u and v are connected at the current time.
+ * - solve():             Returns the answers to all queries, in the order asked.
+ * Nodes are 0-indexed.
+ * =====================================================================================
+ */
+
+// Include guard instead of `#pragma once`: this file is also a main file.
+#ifndef CODEBOOK_OFFLINE_DYNAMIC_CONNECTIVITY
+#define CODEBOOK_OFFLINE_DYNAMIC_CONNECTIVITY
+#include "../data_structures/rollback_dsu.cpp"
+#include "../data_structures/segment_tree.cpp"
+
+struct OfflineDynamicConnectivity {
+    int n;
+    std::vector<std::array<int, 3>> ops; // {type, u, v}; type: 0 add, 1 remove, 2 query
+
+    OfflineDynamicConnectivity(int num_nodes) : n(num_nodes) {}
+
+    void add_edge(int u, int v) { ops.push_back({0, u, v}); }
+    void remove_edge(int u, int v) { ops.push_back({1, u, v}); }
+    void query(int u, int v) { ops.push_back({2, u, v}); }
+
+    std::vector<bool> solve() {
+        int T = ops.size();
+        std::vector<bool> answers;
+        if (T == 0) return answers;
+
+        // 1. Turn the log into lifetimes and hang each edge on its canonical nodes
+        std::vector<std::vector<std::pair<int, int>>> node_edges(4 * T);
+        auto attach = [&](int from, int to, std::pair<int, int> e) {
+            SegTree<>::decompose(T, from, to, [&](int v, int, int) {
+                node_edges[v].push_back(e);
+            });
+        };
+        std::map<std::pair<int, int>, std::vector<int>> open; // edge -> start times
+        for (int t = 0; t < T; ++t) {
+            auto [type, u, v] = ops[t];
+            std::pair<int, int> e = std::minmax(u, v);
+            if (type == 0) {
+                open[e].push_back(t);
+            } else if (type == 1) {
+                auto it = open.find(e);
+                if (it == open.end() || it->second.empty()) continue; // not alive: ignored
+                attach(it->second.back(), t - 1, e);
+                it->second.pop_back();
+            }
+        }
+        for (auto& [e, starts] : open) {
+            for (int start : starts) attach(start, T - 1, e);
+        }
+
+        // 2. DFS over time with union on entry, rollback on exit
+        RollbackDSU dsu(n);
+        std::vector<int> answer_at(T, -1);
+        auto dfs = [&](auto&& self, int v, int tl, int tr) -> void {
+            int snap = dsu.snapshot();
+            for (auto [a, b] : node_edges[v]) dsu.union_sets(a, b);
+            if (tl == tr) {
+                if (ops[tl][0] == 2) answer_at[tl] = dsu.same_set(ops[tl][1], ops[tl][2]);
+            } else {
+                int tm = tl + (tr - tl) / 2; // same split as SegTree
+                self(self, v * 2, tl, tm);
+                self(self, v * 2 + 1, tm + 1, tr);
+            }
+            dsu.rollback(snap);
+        };
+        dfs(dfs, 1, 0, T - 1);
+
+        for (int t = 0; t < T; ++t) {
+            if (ops[t][0] == 2) answers.push_back(answer_at[t]);
+        }
+        return answers;
+    }
+};
+
+/**
+ * =====================================================================================
+ * How to Use:
+ * Input: n q, then q lines of "+ u v" (add), "- u v" (remove) or "? u v" (query).
+ * Example (the second "- 0 1" and "- 1 2" remove edges that are not alive):
+ *   3 7 / + 0 1 / - 0 1 / - 0 1 / - 1 2 / ? 0 1 / + 0 1 / ? 0 1   ->   NO YES
+ * =====================================================================================
+ */
+// Compiled only when this file is built directly, so other files can include it.
+#if __INCLUDE_LEVEL__ == 0
+int main() {
+    // Fast I/O
+    std::ios_base::sync_with_stdio(false);
+    std::cin.tie(NULL);
+
+    int n, q; // Number of nodes and operations
+    std::cin >> n >> q;
+
+    OfflineDynamicConnectivity dc(n);
+    for (int i = 0; i < q; ++i) {
+        char type;
+        int u, v;
+        std::cin >> type >> u >> v;
+        if (type == '+') dc.add_edge(u, v);
+        else if (type == '-') dc.remove_edge(u, v);
+        else dc.query(u, v);
+    }
+
+    for (bool connected : dc.solve()) {
+        std::cout << (connected ? "YES" : "NO") << "\n";
+    }
+
+    return 0;
+}
+#endif
+#endif // CODEBOOK_OFFLINE_DYNAMIC_CONNECTIVITY
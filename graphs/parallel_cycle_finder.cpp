@@ -0,0 +1,499 @@
+/**
+ * =================================================================
+ * Parallel Cycle / SCC Finder (Directed & Undirected)
+ * =================================================================
+ *
+ * Description:
+ * Multi-core counterpart of `CycleDetector` (unified_graph_cycle_finder.cpp)
+ * for very large graphs stored as a `CSRGraph` (csr_graph.cpp). It reports
+ * the same kind of witness: `[start, ..., end, start]`, or empty if the
+ * graph is acyclic. Nodes are assumed to be 1-indexed (from 1 to N).
+ *
+ * - DIRECTED: Forward-Backward-Trim SCC decomposition. A task is a set of
+ * nodes closed under SCC membership. Processing a task:
+ * 1. Trim: repeatedly peel off nodes with no in- or out-edge inside the
+ * task; each is a trivial SCC.
+ * 2. Pick a pivot and BFS forward (FW) and backward (BW) inside the task.
+ * FW n BW is the pivot's SCC.
+ * 3. FW \ SCC, BW \ SCC and the rest can't share an SCC, so they become
+ * three independent tasks.
+ * Tasks run on a small work-stealing pool: every worker pushes and pops
+ * its own deque at the back and, when empty, steals from the front of
+ * another worker's deque (the oldest, usually largest, tasks).
+ * Idle workers sleep on a condition variable until a task is pushed.
+ * A large task is also parallel inside: the trim goes in rounds and both
+ * BFS one level at a time, and each round / level is published as a
+ * "pass" whose chunks the sleeping pool workers wake up and take, next
+ * to the worker that owns the task. No threads are created per pass.
+ * So a graph that is mostly one giant SCC, where the first task is
+ * nearly all the work, still uses every core. One pass is open at a
+ * time; a large task that finds it taken runs its pass alone.
+ * The witness is a BFS inside one non-trivial SCC back to its first node.
+ *
+ * - UNDIRECTED: Workers pull chunks of nodes and feed every edge into a
+ * lock-free `ConcurrentDSU` (concurrent_dsu.cpp). The first edge whose
+ * endpoints are already connected closes a cycle; all workers stop and
+ * the witness is that edge plus a BFS path between its endpoints. As
+ * with `find_cycle_edge()`, parallel edges count as a cycle here.
+ *
+ * Complexity:
+ * - Directed: O((V + E) * depth of the task recursion) work, which is
+ * O((V + E) log V) expected for random pivots; spread over the threads.
+ * - Undirected: O((V + E) * α(V)) work, spread over the threads.
+ * - Space: O(V + E) (a reverse CSR is built for the directed case).
+ *
+ * =================================================================
+ * HOW TO USE
+ * =================================================================
+ *
+ * `CSRGraph g(num_nodes, edges, undirected);`
+ * `ParallelCycleFinder finder(g, undirected, num_threads);`
+ * `vector<int> cycle = finder.find_cycle();`
+ * `auto sccs = finder.strongly_connected_components(); // directed only`
+ *
+ * Build with -pthread.
+ *
+ */
+
+#ifndef CODEBOOK_PARALLEL_CYCLE_FINDER
+#define CODEBOOK_PARALLEL_CYCLE_FINDER
+#include "../data_structures/concurrent_dsu.cpp"
+#include "csr_graph.cpp"
+
+struct ParallelCycleFinder {
+    CSRGraph g;                          // a copy shares the graph's storage, so temporaries are fine
+    bool is_undirected;
+    int num_threads;
+    CSRGraph rg;                         // reverse graph, directed only
+    std::vector<std::atomic<int>> part;  // task id owning each node, -1 once its SCC is known
+    std::vector<int> scc;                // SCC id of each node
+    std::vector<int> deg_in, deg_out;    // scratch for trimming, owned by the node's task
+    std::vector<char> mark;              // scratch: bit 1 reached forward, bit 2 backward
+    std::atomic<int> next_part{0}, next_scc{0};
+
+    // A data-parallel pass of one large task, open to the idle pool workers
+    struct Pass {
+        std::function<void(int, int)> f; // runs one chunk [b, e)
+        int count, chunks;
+        std::atomic<int> next{0};        // next chunk to hand out
+        int helpers = 0;                 // workers inside 'f', guarded by 'wake_lock'
+    };
+    std::mutex wake_lock;
+    std::condition_variable wake;
+    uint64_t wake_gen = 0;               // bumped for every new task / pass, guarded
+    Pass* open_pass = nullptr;           // guarded by 'wake_lock'
+
+    ParallelCycleFinder(CSRGraph graph, bool undirected = false,
+                        int threads = std::max(1u, std::thread::hardware_concurrency()))
+        : g(std::move(graph)), is_undirected(undirected), num_threads(std::max(1, threads)) {}
+
+    // Find a witness cycle, or return an empty vector for an acyclic graph
+    std::vector<int> find_cycle() {
+        if (is_undirected) {
+            return find_cycle_undirected();
+        }
+        strongly_connected_components();
+        // Non-trivial SCC containing the smallest node: deterministic choice
+        for (int v = 1; v <= g.n; v++) {
+            int r = first_of_scc(v);
+            if (r != -1) {
+                return cycle_in_scc(r);
+            }
+        }
+        return {};
+    }
+
+    // DIRECTED only: every SCC, in no particular order
+    std::vector<std::vector<int>> strongly_connected_components() {
+        assert(!is_undirected);
+        int n = g.n;
+        build_reverse();
+        part = std::vector<std::atomic<int>>(n + 1);
+        scc.assign(n + 1, -1);
+        deg_in.assign(n + 1, 0);
+        deg_out.assign(n + 1, 0);
+        mark.assign(n + 1, 0);
+        next_part = 1;
+        next_scc = 0;
+
+        std::vector<int> all(n);
+        std::iota(all.begin(), all.end(), 1);
+        for (int v = 1; v <= n; v++) part[v].store(0, std::memory_order_relaxed);
+        run_tasks(std::move(all));
+
+        std::vector<std::vector<int>> comps(next_scc.load());
+        for (int v = 1; v <= n; v++) comps[scc[v]].push_back(v);
+        return comps;
+    }
+
+    // --- Private Helper Functions (the "engine") ---
+private:
+    static constexpr int PARALLEL_MIN = 1 << 16; // smallest task split across threads
+    static constexpr int GRAIN = 1 << 12;        // fewest nodes per chunk of a pass
+
+    struct Task {
+        int id;
+        std::vector<int> nodes;
+    };
+
+    // Work-stealing pool: one deque per worker, the last worker to finish
+    // a task while nothing is pending shuts everyone down.
+    void run_tasks(std::vector<int> all) {
+        std::vector<std::deque<Task>> queues(num_threads);
+        std::vector<std::mutex> locks(num_threads);
+        std::atomic<long long> pending{1};
+        queues[0].push_back({0, std::move(all)});
+
+        auto worker = [&](int self) {
+            auto push = [&](Task t) {
+                pending.fetch_add(1, std::memory_order_relaxed);
+                {
+                    std::lock_guard<std::mutex> lk(locks[self]);
+                    queues[self].push_back(std::move(t));
+                }
+                notify();
+            };
+            while (pending.load(std::memory_order_acquire) > 0) {
+                uint64_t seen;
+                {
+                    std::lock_guard<std::mutex> lk(wake_lock);
+                    seen = wake_gen;
+                }
+                std::optional<Task> task;
+                for (int k = 0; k < num_threads && !task; k++) {
+                    int q = (self + k) % num_threads;
+                    std::lock_guard<std::mutex> lk(locks[q]);
+                    if (queues[q].empty()) continue;
+                    if (q == self) {
+                        task = std::move(queues[q].back()); // own work: newest first
+                        queues[q].pop_back();
+                    } else {
+                        task = std::move(queues[q].front()); // steal: oldest first
+                        queues[q].pop_front();
+                    }
+                }
+                if (task) {
+                    process(*task, push);
+                    if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) notify(); // all done
+                    continue;
+                }
+                if (help_pass()) continue;
+                // Nothing to do: sleep until a task or a pass shows up, or the end.
+                // Anything published since 'seen' was read has bumped 'wake_gen'.
+                std::unique_lock<std::mutex> lk(wake_lock);
+                wake.wait(lk, [&] {
+                    return wake_gen != seen || pending.load(std::memory_order_acquire) == 0;
+                });
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 1; t < num_threads; t++) threads.emplace_back(worker, t);
+        worker(0);
+        for (auto& th : threads) th.join();
+    }
+
+    bool in_task(int v, int id) const {
+        return part[v].load(std::memory_order_relaxed) == id;
+    }
+
+    void finish(int v, int id) {
+        scc[v] = id;
+        part[v].store(-1, std::memory_order_relaxed);
+    }
+
+    void notify() {
+        {
+            std::lock_guard<std::mutex> lk(wake_lock);
+            ++wake_gen;
+        }
+        wake.notify_all();
+    }
+
+    static void run_chunks(Pass& p) {
+        for (int c; (c = p.next.fetch_add(1, std::memory_order_relaxed)) < p.chunks;) {
+            p.f(c * GRAIN, (int)std::min<long long>(p.count, (long long)(c + 1) * GRAIN));
+        }
+    }
+
+    // Run f(b, e) over [0, count) in chunks. With 'parallel' the chunks are
+    // shared with the idle pool workers; returns once every chunk is done.
+    template <typename F>
+    void run_pass(bool parallel, int count, F&& f) {
+        if (!parallel || num_threads == 1 || count < 2 * GRAIN) {
+            f(0, count);
+            return;
+        }
+        Pass p{std::ref(f), count, (count + GRAIN - 1) / GRAIN};
+        bool opened = false;
+        {
+            std::lock_guard<std::mutex> lk(wake_lock);
+            if (!open_pass) {
+                open_pass = &p;
+                opened = true;
+                ++wake_gen;
+            }
+        }
+        if (!opened) { // another task's pass is open: run this one alone
+            f(0, count);
+            return;
+        }
+        wake.notify_all();
+        run_chunks(p);
+        // Unpublish, then wait for the helpers still inside a chunk
+        std::unique_lock<std::mutex> lk(wake_lock);
+        open_pass = nullptr;
+        wake.wait(lk, [&] { return p.helpers == 0; });
+    }
+
+    // Take chunks of the open pass; false if there is none with chunks left
+    bool help_pass() {
+        Pass* p;
+        {
+            std::lock_guard<std::mutex> lk(wake_lock);
+            p = open_pass;
+            if (!p || p->next.load(std::memory_order_relaxed) >= p->chunks) return false;
+            p->helpers++;
+        }
+        run_chunks(*p);
+        {
+            std::lock_guard<std::mutex> lk(wake_lock);
+            p->helpers--;
+        }
+        wake.notify_all(); // the owner may be waiting for us
+        return true;
+    }
+
+    // Call f(i, out) for i in [0, count) in chunks; returns everything
+    // appended to 'out' (in chunk order only when it ran serially)
+    template <typename F>
+    std::vector<int> gather(bool parallel, int count, F&& f) {
+        std::vector<int> all;
+        std::mutex all_lock;
+        run_pass(parallel, count, [&](int b, int e) {
+            std::vector<int> out;
+            for (int i = b; i < e; i++) f(i, out);
+            std::lock_guard<std::mutex> lk(all_lock);
+            all.insert(all.end(), out.begin(), out.end());
+        });
+        return all;
+    }
+
+    template <typename Push>
+    void process(Task& task, Push&& push) {
+        int id = task.id;
+        bool parallel = (int)task.nodes.size() >= PARALLEL_MIN;
+        trim(task, parallel);
+        if (task.nodes.empty()) return;
+
+        // FW and BW reachability from the pivot, restricted to this task
+        int pivot = task.nodes[0];
+        mark[pivot] = 3;
+        reach(g, pivot, id, 1, parallel);
+        reach(rg, pivot, id, 2, parallel);
+
+        // FW n BW is one SCC; the three remainders become new tasks
+        int comp = next_scc.fetch_add(1, std::memory_order_relaxed);
+        Task parts[3];
+        for (Task& t : parts) t.id = next_part.fetch_add(1, std::memory_order_relaxed);
+        std::mutex parts_lock;
+        run_pass(parallel, task.nodes.size(), [&](int b, int e) {
+            std::vector<int> local[3];
+            for (int i = b; i < e; i++) {
+                int v = task.nodes[i], m = mark[v];
+                mark[v] = 0;
+                if (m == 3) {
+                    finish(v, comp);
+                } else {
+                    // 0: neither, 1: FW only, 2: BW only
+                    part[v].store(parts[m].id, std::memory_order_relaxed);
+                    local[m].push_back(v);
+                }
+            }
+            std::lock_guard<std::mutex> lk(parts_lock);
+            for (int k = 0; k < 3; k++) parts[k].nodes.insert(parts[k].nodes.end(), local[k].begin(), local[k].end());
+        });
+        for (Task& t : parts) {
+            if (!t.nodes.empty()) push(std::move(t));
+        }
+    }
+
+    // Set 'bit' in 'mark' for the nodes of task 'id' that 'graph' reaches from
+    // 'pivot'. Level-synchronous: each level is one pass (shared with the idle
+    // workers if 'parallel'), and a node joins the next level only in the
+    // thread whose fetch_or set the bit.
+    void reach(const CSRGraph& graph, int pivot, int id, char bit, bool parallel) {
+        std::vector<int> frontier = {pivot};
+        while (!frontier.empty()) {
+            frontier = gather(parallel, frontier.size(), [&](int i, std::vector<int>& next) {
+                for (int u : graph.neighbors(frontier[i])) {
+                    if (!in_task(u, id)) continue;
+                    std::atomic_ref<char> m(mark[u]);
+                    if (!(m.load(std::memory_order_relaxed) & bit) && !(m.fetch_or(bit, std::memory_order_relaxed) & bit)) {
+                        next.push_back(u);
+                    }
+                }
+            });
+        }
+    }
+
+    // Peel off nodes without in- or out-edges inside the task: trivial SCCs.
+    // Goes in rounds, each removing the nodes whose degree the last one zeroed.
+    void trim(Task& task, bool parallel) {
+        int id = task.id;
+        std::vector<int> peel = gather(parallel, task.nodes.size(), [&](int i, std::vector<int>& out) {
+            int v = task.nodes[i];
+            deg_in[v] = deg_out[v] = 0;
+            for (int u : g.neighbors(v)) deg_out[v] += in_task(u, id);
+            for (int u : rg.neighbors(v)) deg_in[v] += in_task(u, id);
+            if (deg_in[v] == 0 || deg_out[v] == 0) out.push_back(v);
+        });
+        std::mutex next_lock;
+        while (!peel.empty()) {
+            std::vector<int> next;
+            run_pass(parallel, peel.size(), [&](int b, int e) {
+                std::vector<int> found, done;
+                for (int i = b; i < e; i++) {
+                    int v = peel[i], expected = id;
+                    // Queued twice (both degrees hit zero): only one caller wins
+                    if (!part[v].compare_exchange_strong(expected, -1, std::memory_order_relaxed)) continue;
+                    done.push_back(v);
+                    for (int u : g.neighbors(v)) {
+                        if (in_task(u, id) && std::atomic_ref<int>(deg_in[u]).fetch_sub(1, std::memory_order_relaxed) == 1) {
+                            found.push_back(u);
+                        }
+                    }
+                    for (int u : rg.neighbors(v)) {
+                        if (in_task(u, id) && std::atomic_ref<int>(deg_out[u]).fetch_sub(1, std::memory_order_relaxed) == 1) {
+                            found.push_back(u);
+                        }
+                    }
+                }
+                int comp = next_scc.fetch_add(done.size(), std::memory_order_relaxed);
+                for (int v : done) scc[v] = comp++;
+                std::lock_guard<std::mutex> lk(next_lock);
+                next.insert(next.end(), found.begin(), found.end());
+            });
+            peel.swap(next);
+        }
+        task.nodes = gather(parallel, task.nodes.size(), [&](int i, std::vector<int>& out) {
+            if (in_task(task.nodes[i], id)) out.push_back(task.nodes[i]);
+        });
+    }
+
+    void build_reverse() {
+        std::vector<std::pair<int, int>> edges;
+        edges.reserve(g.num_edges());
+        for (int v = 0; v <= g.n; v++) {
+            for (int u : g.neighbors(v)) edges.push_back({u, v});
+        }
+        rg = CSRGraph(g.n, edges);
+    }
+
+    // Returns v if v is the smallest node of a non-trivial SCC, else -1
+    int first_of_scc(int v) const {
+        bool self_loop = false, bigger = false;
+        for (int u : g.neighbors(v)) {
+            self_loop |= u == v;
+            bigger |= u != v && scc[u] == scc[v];
+        }
+        for (int u : rg.neighbors(v)) {
+            if (u != v && scc[u] == scc[v] && u < v) return -1;
+            bigger |= u != v && scc[u] == scc[v];
+        }
+        return (self_loop || bigger) ? v : -1;
+    }
+
+    // BFS inside r's SCC until an edge leads back to r
+    std::vector<int> cycle_in_scc(int r) {
+        std::vector<int> parent(g.n + 1, -1), queue = {r};
+        parent[r] = r;
+        for (size_t head = 0; head < queue.size(); head++) {
+            int v = queue[head];
+            for (int u : g.neighbors(v)) {
+                if (u == r) return path_cycle(parent, r, v);
+                if (scc[u] == scc[r] && parent[u] == -1) {
+                    parent[u] = v;
+                    queue.push_back(u);
+                }
+            }
+        }
+        return {};
+    }
+
+    // [start, ..., end, start] following `parent` from `end` up to `start`
+    static std::vector<int> path_cycle(const std::vector<int>& parent, int start, int end) {
+        std::vector<int> cycle;
+        cycle.push_back(start);
+        for (int v = end; v != start; v = parent[v]) {
+            cycle.push_back(v);
+        }
+        cycle.push_back(start);
+        std::reverse(cycle.begin(), cycle.end());
+        return cycle;
+    }
+
+    std::vector<int> find_cycle_undirected() {
+        int n = g.n;
+        ConcurrentDSU dsu(n + 1);
+        std::atomic<int> next_chunk{1};
+        std::atomic<bool> found{false};
+        std::pair<int, int> closing = {-1, -1};
+        std::mutex closing_lock;
+        const int CHUNK = 4096;
+
+        auto worker = [&] {
+            while (!found.load(std::memory_order_relaxed)) {
+                int from = next_chunk.fetch_add(CHUNK, std::memory_order_relaxed);
+                if (from > n) return;
+                for (int u = from; u < std::min(n + 1, from + CHUNK); u++) {
+                    for (int v : g.neighbors(u)) {
+                        if (v < u) continue; // each edge is stored both ways
+                        if (!dsu.union_sets(u, v)) {
+                            std::lock_guard<std::mutex> lk(closing_lock);
+                            if (!found.exchange(true)) closing = {u, v};
+                            return;
+                        }
+                    }
+                }
+            }
+        };
+        std::vector<std::thread> threads;
+        for (int t = 1; t < num_threads; t++) threads.emplace_back(worker);
+        worker();
+        for (auto& th : threads) th.join();
+
+        auto [u, v] = closing;
+        if (u == -1) return {};
+        if (u == v) return {u, u};
+        // Path v -> ... -> u that avoids this one copy of the edge u - v
+        std::vector<int> parent(n + 1, -1), queue = {v};
+        parent[v] = v;
+        bool skipped = false;
+        for (size_t head = 0; head < queue.size() && parent[u] == -1; head++) {
+            int x = queue[head];
+            for (int w : g.neighbors(x)) {
+                if (x == v && w == u && !skipped) {
+                    skipped = true;
+                    continue;
+                }
+                if (parent[w] == -1) {
+                    parent[w] = x;
+                    queue.push_back(w);
+                }
+            }
+        }
+        return path_cycle(parent, v, u);
+    }
+};
+
+// --- Example Usage ---
+// int main() {
+//     // 1 -> 2 -> 3 -> 1 plus a tail 3 -> 4
+//     std::vector<std::pair<int, int>> edges = {{1, 2}, {2, 3}, {3, 1}, {3, 4}};
+//     CSRGraph g(4, edges);
+//     ParallelCycleFinder finder(g, false, 8);
+//     for (int v : finder.find_cycle()) std::cout << v << " "; // 1 2 3 1
+//     std::cout << std::endl;
+// }
+#endif // CODEBOOK_PARALLEL_CYCLE_FINDER
@@ -11,6 +11,41 @@
  * ignores the trivial 2-edge cycle back to the parent node.
  * Nodes are assumed to be 1-indexed (from 1 to N).
  *
+ * The DFS is iterative: an explicit stack of (node, next neighbour
+ * index) replaces the call stack, so long paths in huge graphs can't
+ * overflow it. It visits nodes in the same order as the recursive
+ * version would, so the reported cycle is the same.
+ *
+ * Repeated calls are cheap: `find_cycle()` marks nodes with a generation
+ * counter (a node is white unless stamped in the current call), so
+ * nothing is refilled between calls, and `reset()` drops the edges but
+ * keeps every buffer's capacity. The cycle can be written into a
+ * caller-owned vector, already in order.
+ *
+ * For undirected graphs there is also `find_cycle_edge()`, which needs
+ * no DFS at all: edges are fed into a `DSU` (dsu.cpp) and the first one
+ * whose endpoints are already connected closes a cycle.
+ *
+ * `find_all_cycles()` reports every problem in one O(V + E) pass
+ * instead of one cycle at a time:
+ * - Directed: the strongly connected components (iterative Tarjan) and
+ * one witness cycle per non-trivial SCC (size > 1, or a self-loop).
+ * - Undirected: the biconnected components, the bridges, and one witness
+ * cycle per biconnected component with more than one edge (plus one per
+ * self-loop). As in `find_cycle()`, parallel edges count as one edge.
+ * It works in the same `parent` scratch array as `find_cycle()`, plus
+ * `color`, `tin` and `low`.
+ *
+ * `add_edge_checked(u, v)` inserts an edge only if it keeps the graph
+ * acyclic, keeping state between calls instead of re-running a DFS:
+ * - Undirected: a `DSU` of the components; O(α(N)) per insert.
+ * - Directed: an incremental topological order (Pearce & Kelly). An edge
+ * that agrees with the order is O(1). Otherwise only the nodes whose
+ * positions lie between the two endpoints are searched and reordered,
+ * which is far below O(V + E) per insert on typical DAG workloads.
+ * The state is built from the current edges on first use and rebuilt if
+ * plain `add_edge` is called in between.
+ *
  * Complexity:
  * - Time: O(V + E)
  * - Space: O(V)
@@ -27,87 +62,570 @@
  *
  * 3.  Add edges:
  * `detector.add_edge(u, v);`
+ * or read 'm' of them straight from the input (io/fast_io.cpp):
+ * `FastInput in; detector.read_edges(in, m);`
  *
  * 4.  Find a cycle:
  * `vector<int> cycle = detector.find_cycle();`
  *
  * 5.  Check if a cycle was found:
  * `if (cycle.empty()) { ... }`
+ * Hot loops can reuse one buffer instead:
+ * `if (detector.find_cycle(buffer)) { ... }`
+ * and recycle the detector for the next graph of similar size:
+ * `detector.reset();` or `detector.reset(new_num_nodes);`
+ *
+ * 6.  UNDIRECTED only, when just a yes / no (and a witness edge) is needed:
+ * `auto [u, v] = detector.find_cycle_edge(); // {-1, -1} if acyclic`
+ *
+ * 7.  All components and one witness cycle per component, in one pass:
+ * `CycleDetector::CycleReport r = detector.find_all_cycles();`
+ * `r.components` (SCCs / biconnected components), `r.bridges`
+ * (undirected only), `r.cycles` (each in the `find_cycle()` format).
+ *
+ * 8.  Streaming inserts that must never close a cycle (e.g. scheduler DAGs):
+ * `if (!detector.add_edge_checked(u, v)) { ... rejected, not added ... }`
+ *
+ * 9.  Or run directly on a prebuilt `CSRGraph` (csr_graph.cpp). The detector
+ * shares its storage, so nothing is copied. For undirected graphs build it with
+ * both directions:
+ * `CSRGraph g(num_nodes, edges, true);`
+ * `CycleDetector detector(g, true);`
+ * Edges added later (`add_edge`, `read_edges`, `add_edge_checked`) go on top of
+ * the CSR edges: the first one copies the CSR lists into per-node vectors, once,
+ * and the detector continues on those.
+ *
+ * 10. Or hand over the whole edge list at once, for large loads:
+ * `CycleDetector detector(num_nodes, edges, undirected);`
+ * The adjacency is then built as a `CSRGraph` in one counting sort: a few
+ * allocations in total instead of a growing vector per node, no
+ * fragmentation, and `reset()` (or destruction) frees it in O(1). Adding edges
+ * afterwards works as in 9.
  *
  */
 
-#include <bits/stdc++.h>
+#include "../data_structures/dsu.cpp"
+#include "csr_graph.cpp"
+#include "../io/fast_io.cpp"
 
 struct CycleDetector {
     int n;
     bool is_undirected;
     std::vector<std::vector<int>> adj;
-    std::vector<char> color; // 0: white, 1: gray, 2: black
+    std::optional<CSRGraph> graph; // if set, used instead of 'adj' (shares storage, cheap)
+    std::vector<uint32_t> visit; // find_cycle: < epoch white, == epoch gray, epoch + 1 black
+    uint32_t epoch = 0;
+    std::vector<std::pair<int, int>> dfs_stack; // {node, next neighbour index}
+    std::vector<char> color;
     std::vector<int> parent;
+    std::vector<int> tin, low; // DFS entry times and low-links (find_all_cycles)
     int cycle_start, cycle_end;
 
+    // State kept between add_edge_checked calls
+    bool checked_ready = false;
+    bool checked_cyclic = false;         // the graph already had a cycle
+    DSU<true> checked_dsu{0};            // undirected: connected components
+    std::vector<std::vector<int>> radj;  // directed: reverse edges
+    std::vector<int> ord, at;            // directed: topological position, and its inverse
+    std::vector<char> mark;              // directed: nodes touched by the current insert
+
+    struct CycleReport {
+        std::vector<std::vector<int>> components; // SCCs, or biconnected components
+        std::vector<std::pair<int, int>> bridges; // undirected only
+        std::vector<std::vector<int>> cycles;     // one witness per non-trivial component
+    };
+
     // Constructor: specify if the graph is undirected
     CycleDetector(int num_nodes, bool undirected = false) : n(num_nodes), is_undirected(undirected) {
         adj.resize(n + 1); // 1-indexed
     }
 
+    // Constructor over a CSR adjacency (edges added later are kept on top of it)
+    CycleDetector(const CSRGraph& g, bool undirected = false)
+        : n(g.n), is_undirected(undirected), graph(g) {}
+
+    // Constructor from the whole edge list: builds the CSR adjacency in one
+    // pass (both directions if undirected)
+    CycleDetector(int num_nodes, const std::vector<std::pair<int, int>>& edges, bool undirected = false)
+        : CycleDetector(CSRGraph(num_nodes, edges, undirected), undirected) {}
+
     // Add an edge. For undirected, adds the reverse edge automatically.
     void add_edge(int u, int v) {
+        own_adjacency();
         adj[u].push_back(v);
         if (is_undirected) {
             adj[v].push_back(u);
         }
+        checked_ready = false; // may have closed a cycle behind our back
+    }
+
+    // Read 'm' edges "u v" from 'in' and add them. Every adjacency list is
+    // sized from the degrees first, so none of them grows more than once.
+    void read_edges(FastInput& in, int m) {
+        own_adjacency();
+        std::vector<std::pair<int, int>> edges(m);
+        std::vector<int> extra(n + 1, 0);
+        for (auto& [u, v] : edges) {
+            u = in.read(), v = in.read();
+            extra[u]++;
+            if (is_undirected) extra[v]++;
+        }
+        for (int v = 0; v <= n; ++v) {
+            if (extra[v]) adj[v].reserve(adj[v].size() + extra[v]);
+        }
+        for (auto [u, v] : edges) add_edge(u, v);
+    }
+
+    // Drop every edge but keep all allocated capacity. Optionally change
+    // the number of nodes; the adjacency lists that remain keep theirs too.
+    // A CSR adjacency is released, and add_edge can be used afterwards.
+    void reset(int num_nodes = -1) {
+        graph.reset();
+        if (num_nodes >= 0) {
+            n = num_nodes;
+        }
+        adj.resize(n + 1);
+        for (auto& list : adj) list.clear();
+        checked_ready = false;
+    }
+
+    // Add the edge only if it does not create a cycle. Returns false (and
+    // leaves the graph unchanged) if it would.
+    bool add_edge_checked(int u, int v) {
+        own_adjacency();
+        if (!checked_ready) {
+            init_checked();
+        }
+        if (checked_cyclic) {
+            return false;
+        }
+        if (is_undirected) {
+            if (checked_dsu.find_set(u) == checked_dsu.find_set(v)) {
+                return false;
+            }
+            checked_dsu.union_sets(u, v);
+            adj[u].push_back(v);
+            adj[v].push_back(u);
+            return true;
+        }
+        if (u == v || (ord[u] > ord[v] && !reorder(u, v))) {
+            return false;
+        }
+        adj[u].push_back(v);
+        radj[v].push_back(u);
+        return true;
     }
 
 private:
-    // Internal DFS. `p` is the parent in the DFS tree.
-    bool dfs(int v, int p) {
-        color[v] = 1; // Mark as gray (visiting)
-        parent[v] = p;
+    // Build the add_edge_checked state from the edges added so far
+    void init_checked() {
+        checked_ready = true;
+        checked_cyclic = false;
+        if (is_undirected) {
+            checked_dsu = DSU<true>(n + 1); // 1-indexed
+            for (int u = 1; u <= n; u++) {
+                int self_loops = 0;
+                for (int v : adj[u]) {
+                    // Each edge is stored both ways: take it from its smaller end
+                    if (v < u || (v == u && self_loops++ % 2)) continue;
+                    if (checked_dsu.find_set(u) == checked_dsu.find_set(v)) checked_cyclic = true;
+                    checked_dsu.union_sets(u, v);
+                }
+            }
+            return;
+        }
+        // Directed: reverse edges plus any topological order (Kahn)
+        radj.assign(n + 1, {});
+        std::vector<int> indeg(n + 1, 0);
+        for (int u = 1; u <= n; u++) {
+            for (int v : adj[u]) {
+                radj[v].push_back(u);
+                indeg[v]++;
+            }
+        }
+        at.clear();
+        for (int v = 1; v <= n; v++) {
+            if (indeg[v] == 0) at.push_back(v);
+        }
+        for (size_t head = 0; head < at.size(); head++) {
+            for (int v : adj[at[head]]) {
+                if (--indeg[v] == 0) at.push_back(v);
+            }
+        }
+        if ((int)at.size() < n) {
+            checked_cyclic = true;
+            return;
+        }
+        ord.assign(n + 1, 0);
+        for (int i = 0; i < n; i++) ord[at[i]] = i;
+        mark.assign(n + 1, 0);
+    }
+
+    // Pearce-Kelly: make room for u -> v when ord[u] > ord[v]. Returns false
+    // if v reaches u, i.e. the edge would close a cycle.
+    bool reorder(int u, int v) {
+        int lo = ord[v], hi = ord[u];
+        // Forward from v through nodes placed no later than u
+        std::vector<int> forward = {v}, backward = {u};
+        mark[v] = 1;
+        for (size_t i = 0; i < forward.size(); i++) {
+            for (int w : adj[forward[i]]) {
+                if (w == u) {
+                    for (int x : forward) mark[x] = 0;
+                    return false;
+                }
+                if (!mark[w] && ord[w] < hi) {
+                    mark[w] = 1;
+                    forward.push_back(w);
+                }
+            }
+        }
+        // Backward from u through nodes placed no earlier than v
+        mark[u] = 1;
+        for (size_t i = 0; i < backward.size(); i++) {
+            for (int w : radj[backward[i]]) {
+                if (!mark[w] && ord[w] > lo) {
+                    mark[w] = 1;
+                    backward.push_back(w);
+                }
+            }
+        }
+        // Reuse the positions of both sets: everything that reaches u first,
+        // then everything reachable from v, each keeping its relative order.
+        auto by_ord = [&](int a, int b) { return ord[a] < ord[b]; };
+        std::sort(forward.begin(), forward.end(), by_ord);
+        std::sort(backward.begin(), backward.end(), by_ord);
+        std::vector<int> slots;
+        slots.reserve(forward.size() + backward.size());
+        for (int x : backward) slots.push_back(ord[x]);
+        for (int x : forward) slots.push_back(ord[x]);
+        std::sort(slots.begin(), slots.end());
+        int k = 0;
+        for (int x : backward) ord[x] = slots[k++];
+        for (int x : forward) ord[x] = slots[k++];
+        for (int x : backward) {
+            at[ord[x]] = x;
+            mark[x] = 0;
+        }
+        for (int x : forward) {
+            at[ord[x]] = x;
+            mark[x] = 0;
+        }
+        return true;
+    }
+
+    // A CSRGraph is immutable: before the first added edge, copy its lists
+    // into 'adj' (in the same order) and continue on those
+    void own_adjacency() {
+        if (!graph) {
+            return;
+        }
+        adj.resize(n + 1);
+        for (int v = 0; v <= n; ++v) {
+            auto nb = graph->neighbors(v);
+            adj[v].assign(nb.begin(), nb.end());
+        }
+        graph.reset();
+        checked_ready = false;
+    }
+
+    // Calls fn(neighbors) with an accessor for whichever adjacency is in use
+    template <typename Fn>
+    auto with_neighbors(Fn&& fn) {
+        if (graph) {
+            return fn([&](int v) { return graph->neighbors(v); });
+        }
+        return fn([&](int v) -> const std::vector<int>& { return adj[v]; });
+    }
+
+    // Internal DFS from `root`, driven by an explicit stack of
+    // {node, index of the next neighbour to look at}.
+    template <typename Neighbors>
+    bool dfs(int root, const Neighbors& neighbors) {
+        const uint32_t gray = epoch, black = epoch + 1;
+        dfs_stack.clear();
+        visit[root] = gray; // Mark as gray (visiting)
+        parent[root] = -1;
+        dfs_stack.push_back({root, 0});
+
+        while (!dfs_stack.empty()) {
+            int v = dfs_stack.back().first;
+            int& next = dfs_stack.back().second;
+            auto&& adj_v = neighbors(v);
+            if (next == (int)adj_v.size()) {
+                visit[v] = black; // Mark as black (finished)
+                dfs_stack.pop_back();
+                continue;
+            }
+            int u = adj_v[next++];
 
-        for (int u : adj[v]) {
             // For undirected graphs, skip the edge back to the immediate parent
-            if (is_undirected && u == p) {
+            if (is_undirected && u == parent[v]) {
                 continue;
             }
 
-            if (color[u] == 0) { // If neighbor is white (unvisited)
-                if (dfs(u, v)) return true;
-            } else if (color[u] == 1) { // Found a back edge to a gray node
+            if (visit[u] < gray) { // If neighbor is white (unvisited)
+                visit[u] = gray;
+                parent[u] = v;
+                dfs_stack.push_back({u, 0});
+            } else if (visit[u] == gray) { // Found a back edge to a gray node
                 cycle_end = v;
                 cycle_start = u;
                 return true;
             }
         }
-        color[v] = 2; // Mark as black (finished)
         return false;
     }
 
+    // Write [start, ..., end, start] into `out`, following `parent` from
+    // `end` up to `start`. The length is counted first, so the path can
+    // be filled back to front, already in order.
+    void write_cycle(int start, int end, std::vector<int>& out) const {
+        int len = 0;
+        for (int v = end; v != start; v = parent[v]) {
+            len++;
+        }
+        out.resize(len + 2);
+        out[0] = out[len + 1] = start;
+        for (int v = end, i = len; v != start; v = parent[v], i--) {
+            out[i] = v;
+        }
+    }
+
 public:
+    // Find a cycle and write it into `cycle` (whose capacity is reused).
+    // Returns false, with `cycle` emptied, if there is none.
+    bool find_cycle(std::vector<int>& cycle) {
+        // New generation: every stamp from earlier calls now reads as white
+        if ((int)visit.size() != n + 1 || epoch >= UINT32_MAX - 2) {
+            visit.assign(n + 1, 0); // 1-indexed
+            epoch = 0;
+        }
+        epoch += 2;
+        parent.resize(n + 1); // entries are written before they are read
+        cycle_start = -1;
+
+        with_neighbors([&](const auto& neighbors) {
+            for (int v = 1; v <= n; v++) { // 1-indexed
+                if (visit[v] < epoch && dfs(v, neighbors)) {
+                    break;
+                }
+            }
+        });
+
+        if (cycle_start == -1) {
+            cycle.clear();
+            return false; // No cycle found
+        }
+        write_cycle(cycle_start, cycle_end, cycle);
+        return true;
+    }
+
     // Main method to find and return a cycle
     std::vector<int> find_cycle() {
+        std::vector<int> cycle;
+        find_cycle(cycle);
+        return cycle;
+    }
+
+    // UNDIRECTED only: first edge (in adjacency scan order) that closes a
+    // cycle, found with union-find instead of a DFS. Unlike find_cycle(),
+    // parallel edges count as a cycle here. Returns {-1, -1} if acyclic.
+    std::pair<int, int> find_cycle_edge() {
+        assert(is_undirected);
+        DSU<true> dsu(n + 1); // 1-indexed
+        return with_neighbors([&](const auto& neighbors) -> std::pair<int, int> {
+            for (int u = 1; u <= n; u++) {
+                int self_loops = 0;
+                for (int v : neighbors(u)) {
+                    // Each edge is stored both ways: look at it from its smaller end.
+                    // A self-loop is stored twice in its own list; use one copy.
+                    if (v < u || (v == u && self_loops++ % 2)) {
+                        continue;
+                    }
+                    if (dsu.find_set(u) == dsu.find_set(v)) {
+                        return {u, v};
+                    }
+                    dsu.union_sets(u, v);
+                }
+            }
+            return {-1, -1};
+        });
+    }
+
+    // Every SCC (directed) or biconnected component and bridge (undirected),
+    // plus one witness cycle per non-trivial component, in one pass
+    CycleReport find_all_cycles() {
+        CycleReport report;
         color.assign(n + 1, 0);    // 1-indexed
         parent.assign(n + 1, -1); // 1-indexed
-        cycle_start = -1;
+        tin.assign(n + 1, -1);
+        low.assign(n + 1, 0);
+        with_neighbors([&](const auto& neighbors) {
+            if (is_undirected) {
+                biconnected(neighbors, report);
+            } else {
+                strongly_connected(neighbors, report);
+            }
+        });
+        return report;
+    }
+
+private:
+    // Iterative Tarjan SCC. color: 1 while on the SCC stack, 2 once assigned.
+    template <typename Neighbors>
+    void strongly_connected(const Neighbors& neighbors, CycleReport& report) {
+        std::vector<std::pair<int, int>> stack; // {node, next neighbour index}
+        std::vector<int> open;                  // nodes not yet assigned to an SCC
+        int timer = 0;
+        for (int s = 1; s <= n; s++) {
+            if (tin[s] != -1) continue;
+            tin[s] = low[s] = timer++;
+            color[s] = 1;
+            open.push_back(s);
+            stack.push_back({s, 0});
+            while (!stack.empty()) {
+                int v = stack.back().first;
+                int& next = stack.back().second;
+                auto&& adj_v = neighbors(v);
+                if (next < (int)adj_v.size()) {
+                    int u = adj_v[next++];
+                    if (tin[u] == -1) {
+                        tin[u] = low[u] = timer++;
+                        color[u] = 1;
+                        open.push_back(u);
+                        stack.push_back({u, 0});
+                    } else if (color[u] == 1) {
+                        low[v] = std::min(low[v], tin[u]);
+                    }
+                    continue;
+                }
+                stack.pop_back();
+                if (!stack.empty()) {
+                    int p = stack.back().first;
+                    low[p] = std::min(low[p], low[v]);
+                }
+                if (low[v] == tin[v]) { // 'v' is the root of an SCC
+                    std::vector<int> comp;
+                    int w;
+                    do {
+                        w = open.back();
+                        open.pop_back();
+                        color[w] = 2;
+                        low[w] = report.components.size(); // low now holds the SCC id
+                        comp.push_back(w);
+                    } while (w != v);
+                    report.components.push_back(std::move(comp));
+                }
+            }
+        }
 
-        for (int v = 1; v <= n; v++) { // 1-indexed
-            if (color[v] == 0 && dfs(v, -1)) {
-                break;
+        // Witness per non-trivial SCC: BFS inside the SCC from its first node
+        // until an edge leads back to it. Each SCC is scanned at most once.
+        std::vector<int> queue;
+        for (int id = 0; id < (int)report.components.size(); id++) {
+            int r = report.components[id][0];
+            queue.assign(1, r);
+            color[r] = 3; // 3: reached by this BFS
+            int last = -1;
+            for (size_t head = 0; head < queue.size() && last == -1; head++) {
+                int v = queue[head];
+                for (int u : neighbors(v)) {
+                    if (u == r) {
+                        last = v;
+                        break;
+                    }
+                    if (low[u] == id && color[u] != 3) {
+                        color[u] = 3;
+                        parent[u] = v;
+                        queue.push_back(u);
+                    }
+                }
+            }
+            if (last != -1) {
+                report.cycles.push_back(tree_path_cycle(r, last));
             }
         }
+    }
 
-        if (cycle_start == -1) {
-            return {}; // No cycle found
+    // Iterative low-link DFS for bridges and biconnected components.
+    // color bit 1: collected into the current component, bit 2: self-loop seen.
+    template <typename Neighbors>
+    void biconnected(const Neighbors& neighbors, CycleReport& report) {
+        std::vector<std::pair<int, int>> stack; // {node, next neighbour index}
+        std::vector<std::pair<int, int>> edges; // edges of the components still open
+        int timer = 0;
+        for (int s = 1; s <= n; s++) {
+            if (tin[s] != -1) continue;
+            tin[s] = low[s] = timer++;
+            stack.push_back({s, 0});
+            while (!stack.empty()) {
+                int v = stack.back().first;
+                int& next = stack.back().second;
+                auto&& adj_v = neighbors(v);
+                if (next < (int)adj_v.size()) {
+                    int u = adj_v[next++];
+                    if (u == parent[v]) continue; // the tree edge itself
+                    if (u == v) { // a self-loop is its own cycle; report it once
+                        if (!(color[v] & 2)) report.cycles.push_back({v, v});
+                        color[v] |= 2;
+                        continue;
+                    }
+                    if (tin[u] == -1) {
+                        parent[u] = v;
+                        tin[u] = low[u] = timer++;
+                        edges.push_back({v, u});
+                        stack.push_back({u, 0});
+                    } else if (tin[u] < tin[v]) { // back edge to an ancestor
+                        low[v] = std::min(low[v], tin[u]);
+                        edges.push_back({v, u});
+                    }
+                    continue;
+                }
+                stack.pop_back();
+                int p = parent[v];
+                if (p == -1) continue;
+                low[p] = std::min(low[p], low[v]);
+                if (low[v] > tin[p]) {
+                    report.bridges.push_back({p, v});
+                }
+                if (low[v] >= tin[p]) { // 'p' separates the subtree of 'v'
+                    pop_component(p, v, edges, report);
+                }
+            }
         }
+    }
 
-        std::vector<int> cycle;
-        cycle.push_back(cycle_start);
-        for (int v = cycle_end; v != cycle_start; v = parent[v]) {
-            cycle.push_back(v);
+    // Pop the edges of one biconnected component, ending with tree edge p-v
+    void pop_component(int p, int v, std::vector<std::pair<int, int>>& edges, CycleReport& report) {
+        std::vector<int> comp;
+        std::pair<int, int> back_edge = {-1, -1};
+        int count = 0;
+        std::pair<int, int> e;
+        do {
+            e = edges.back();
+            edges.pop_back();
+            count++;
+            for (int x : {e.first, e.second}) {
+                if (!(color[x] & 1)) { // bit 1 marks members while collecting
+                    color[x] |= 1;
+                    comp.push_back(x);
+                }
+            }
+            if (parent[e.second] != e.first) back_edge = e;
+        } while (e != std::make_pair(p, v));
+        for (int x : comp) color[x] &= ~1;
+        report.components.push_back(std::move(comp));
+        if (count > 1) {
+            // back edge x -> y with y an ancestor: y ... x along the tree, then back
+            report.cycles.push_back(tree_path_cycle(back_edge.second, back_edge.first));
         }
-        cycle.push_back(cycle_start);
-        std::reverse(cycle.begin(), cycle.end());
+    }
 
+    // [start, ..., end, start] following `parent` from `end` up to `start`
+    std::vector<int> tree_path_cycle(int start, int end) const {
+        std::vector<int> cycle;
+        write_cycle(start, end, cycle);
         return cycle;
     }
-};
\ No newline at end of file
+};
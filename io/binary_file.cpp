@@ -0,0 +1,188 @@
+/**
+ * =================================================================
+ * Versioned Flat Binary Files (save / mmap load)
+ * =================================================================
+ *
+ * Description:
+ * A minimal container for prebuilt structures that are expensive to
+ * recompute (LCA tables, CSR graphs): a header, a table of sections,
+ * then each section as a raw, 64-byte aligned array of int32.
+ *
+ *   [BinaryHeader][BinarySection x count][pad][section 0][pad][section 1]...
+ *
+ * - `magic` names the kind of structure ("CBLCA", "CBCSR", ...) and
+ * `version` its layout; a reader only accepts the exact pair it was
+ * written for, so stale files are rejected instead of misread.
+ * - `byte_order` is written as 0x01020304, which rejects files from a
+ * machine of the other endianness.
+ * - Files are loaded with a read-only shared `mmap`: nothing is parsed
+ * or copied, pages are read on first touch, and every process that maps
+ * the same file shares one copy in the page cache. Without `mmap` the
+ * file is read into memory instead.
+ *
+ * `BinaryFile::save` writes a temporary file next to the target and
+ * `rename`s it over the target, so re-saving never truncates a file
+ * that another process has mapped: those keep the old contents (and
+ * no SIGBUS), and new `open`s see the new file.
+ *
+ * `BinaryFile::open` returns `std::nullopt` for a missing, truncated
+ * or mismatched file. The spans stay valid as long as any copy of the
+ * `BinaryFile` (which shares the mapping) is alive.
+ *
+ * Complexity:
+ * - Save: O(file size)
+ * - Load: O(number of sections); the data itself is paged in lazily.
+ *
+ */
+
+#ifndef CODEBOOK_BINARY_FILE
+#define CODEBOOK_BINARY_FILE
+#include <bits/stdc++.h>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CODEBOOK_BINARY_FILE_MMAP 1
+#endif
+
+struct BinaryHeader {
+    char magic[8];       // kind of structure, NUL-padded
+    uint32_t version;    // layout version of that kind
+    uint32_t byte_order; // 0x01020304 as written
+    uint64_t count;      // number of sections
+};
+
+struct BinarySection {
+    uint64_t offset; // from the start of the file, a multiple of 64
+    uint64_t length; // number of int32 elements
+};
+
+struct BinaryFile {
+    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+    static constexpr uint64_t ALIGN = 64;
+
+    std::shared_ptr<const void> storage; // the mapping (or buffer) the sections point into
+    std::vector<std::span<const int32_t>> sections;
+
+    // Write 'sections' under (magic, version). Returns false on any I/O error.
+    static bool save(const std::string& path, const char* magic, uint32_t version,
+                     std::initializer_list<std::span<const int32_t>> sections) {
+        BinaryHeader header{};
+        set_magic(header.magic, magic);
+        header.version = version;
+        header.byte_order = BYTE_ORDER_MARK;
+        header.count = sections.size();
+        std::vector<BinarySection> table;
+        uint64_t pos = sizeof(BinaryHeader) + sections.size() * sizeof(BinarySection);
+        for (auto s : sections) {
+            pos = align_up(pos);
+            table.push_back({pos, s.size()});
+            pos += s.size_bytes();
+        }
+
+        // Same directory as 'path', so the rename below never crosses file systems
+        std::string tmp = path + ".tmp";
+#ifdef CODEBOOK_BINARY_FILE_MMAP
+        tmp += "." + std::to_string(getpid()); // concurrent savers don't share it
+#endif
+        FILE* f = std::fopen(tmp.c_str(), "wb");
+        if (!f) return false;
+        bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1 &&
+                  std::fwrite(table.data(), sizeof(BinarySection), table.size(), f) == table.size();
+        uint64_t written = sizeof(BinaryHeader) + table.size() * sizeof(BinarySection);
+        static const char zeros[ALIGN] = {};
+        int i = 0;
+        for (auto s : sections) {
+            ok = ok && std::fwrite(zeros, 1, table[i].offset - written, f) == table[i].offset - written;
+            ok = ok && std::fwrite(s.data(), sizeof(int32_t), s.size(), f) == s.size();
+            written = table[i++].offset + s.size_bytes();
+        }
+        ok = std::fclose(f) == 0 && ok;
+        // Atomically replace 'path': existing mappings keep the old inode
+        if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+            std::remove(tmp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // Map 'path' and check that it holds (magic, version) with 'count' sections
+    static std::optional<BinaryFile> open(const std::string& path, const char* magic, uint32_t version,
+                                          size_t count) {
+        auto [data, size, storage] = map(path);
+        if (!data || size < sizeof(BinaryHeader)) return std::nullopt;
+        BinaryHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        char expected[sizeof(header.magic)] = {};
+        set_magic(expected, magic);
+        if (std::memcmp(header.magic, expected, sizeof(expected)) != 0 || header.version != version ||
+            header.byte_order != BYTE_ORDER_MARK || header.count != count ||
+            size < sizeof(BinaryHeader) + count * sizeof(BinarySection)) {
+            return std::nullopt;
+        }
+
+        BinaryFile file;
+        file.storage = std::move(storage);
+        for (size_t i = 0; i < count; ++i) {
+            BinarySection s;
+            std::memcpy(&s, data + sizeof(BinaryHeader) + i * sizeof(BinarySection), sizeof(s));
+            if (s.offset % ALIGN != 0 || s.offset > size || s.length > (size - s.offset) / sizeof(int32_t)) {
+                return std::nullopt;
+            }
+            file.sections.push_back({(const int32_t*)(data + s.offset), (size_t)s.length});
+        }
+        return file;
+    }
+
+private:
+    static uint64_t align_up(uint64_t pos) { return (pos + ALIGN - 1) / ALIGN * ALIGN; }
+
+    // Copy up to 8 characters of 'magic' into a zeroed 'out'
+    static void set_magic(char (&out)[8], const char* magic) {
+        std::memcpy(out, magic, std::min(std::strlen(magic), sizeof(out)));
+    }
+
+    struct Mapping {
+        const char* data;
+        size_t size;
+        std::shared_ptr<const void> owner;
+    };
+
+    static Mapping map(const std::string& path) {
+#ifdef CODEBOOK_BINARY_FILE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return {nullptr, 0, nullptr};
+        struct stat st;
+        void* m = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            m = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        ::close(fd); // the mapping keeps the file alive
+        if (m == MAP_FAILED) return {nullptr, 0, nullptr};
+        size_t size = st.st_size;
+        std::shared_ptr<const void> owner(m, [size](const void* p) { munmap(const_cast<void*>(p), size); });
+        return {(const char*)m, size, std::move(owner)};
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) return {nullptr, 0, nullptr};
+        size_t size = in.tellg();
+        // uint64_t elements keep the sections 8-byte aligned; 64 is not needed for correctness
+        auto buffer = std::make_shared<std::vector<uint64_t>>((size + 7) / 8);
+        in.seekg(0);
+        if (!in.read((char*)buffer->data(), size)) return {nullptr, 0, nullptr};
+        return {(const char*)buffer->data(), size, std::move(buffer)};
+#endif
+    }
+};
+
+// --- Example Usage ---
+// int main() {
+//     std::vector<int32_t> a = {1, 2, 3}, b = {42};
+//     BinaryFile::save("demo.bin", "DEMO", 1, {a, b});
+//     if (auto file = BinaryFile::open("demo.bin", "DEMO", 1, 2)) {
+//         std::cout << file->sections[0][2] << " " << file->sections[1][0] << std::endl; // 3 42
+//     }
+// }
+#endif // CODEBOOK_BINARY_FILE
@@ -0,0 +1,225 @@
+/**
+ * =================================================================
+ * Fast Integer I/O (FastInput / FastOutput)
+ * =================================================================
+ *
+ * Description:
+ * Drop-in replacements for `std::cin >> x` and `std::cout << x << '\n'`
+ * when the input is millions of integers and parsing dominates the
+ * run time.
+ *
+ * `FastInput` sees the whole input as one contiguous byte range:
+ * - a regular file (e.g. `./prog < input.txt`) is `mmap`ed, so nothing
+ * is copied at all;
+ * - anything else (a pipe, a terminal) is read to the end with large
+ * `fread` calls into one buffer.
+ * Either way the parser never refills or re-checks a buffer mid-number.
+ * Digits are parsed 8 at a time: one 8-byte load finds the number of
+ * leading digits with a bit trick and folds them with three multiplies,
+ * instead of a compare and a multiply per character.
+ *
+ * `FastOutput` formats integers two digits at a time into a 64 KiB
+ * buffer and hands it to `fwrite` when full, and once more on
+ * destruction.
+ *
+ * Construct `FastInput` before anything else reads the stream: a mapped
+ * file is read from the file offset, past any data stdio has buffered.
+ *
+ * Complexity:
+ * - Time: O(input size); a few instructions per 8 digits.
+ * - Space: O(1) for a mapped file, O(input size) for a pipe.
+ *
+ */
+
+#ifndef CODEBOOK_FAST_IO
+#define CODEBOOK_FAST_IO
+#include <bits/stdc++.h>
+
+#if __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CODEBOOK_FAST_IO_MMAP 1
+#endif
+
+struct FastInput {
+    const char* p = nullptr;   // next unread byte
+    const char* end = nullptr; // one past the last byte
+    std::vector<char> buffer;  // owns the bytes when the input is not mapped
+    void* mapped = nullptr;
+    size_t mapped_size = 0;
+
+    FastInput(FILE* f = stdin) {
+#ifdef CODEBOOK_FAST_IO_MMAP
+        int fd = fileno(f);
+        struct stat st;
+        off_t start = lseek(fd, 0, SEEK_CUR);
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && start >= 0 && st.st_size > start) {
+            void* m = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m != MAP_FAILED) {
+                madvise(m, st.st_size, MADV_SEQUENTIAL);
+                mapped = m;
+                mapped_size = st.st_size;
+                p = (const char*)m + start;
+                end = (const char*)m + st.st_size;
+                return;
+            }
+        }
+#endif
+        // Not mappable: read everything
+        size_t size = 0;
+        buffer.resize(1 << 20);
+        while (size_t got = fread(buffer.data() + size, 1, buffer.size() - size, f)) {
+            size += got;
+            if (size == buffer.size()) buffer.resize(buffer.size() * 2);
+        }
+        p = buffer.data();
+        end = buffer.data() + size;
+    }
+
+    ~FastInput() {
+#ifdef CODEBOOK_FAST_IO_MMAP
+        if (mapped) munmap(mapped, mapped_size);
+#endif
+    }
+
+    FastInput(const FastInput&) = delete;
+    FastInput& operator=(const FastInput&) = delete;
+
+    // Reads the next integer, skipping anything that is not a digit or '-'.
+    // Returns 0 at the end of the input.
+    template<typename T = int>
+    T read() {
+        while (p < end && !is_digit(*p) && *p != '-') ++p;
+        bool negative = p < end && *p == '-';
+        if (negative) ++p;
+        uint64_t x = 0;
+        while (end - p >= 8) {
+            uint64_t chunk;
+            std::memcpy(&chunk, p, 8);
+            int len = leading_digits(chunk);
+            if (len == 0) break;
+            x = x * POW10[len] + fold_digits(chunk << (64 - 8 * len));
+            p += len;
+            if (len < 8) break;
+        }
+        if (end - p < 8) { // the last few bytes of the input, one at a time
+            while (p < end && is_digit(*p)) x = x * 10 + (*p++ - '0');
+        }
+        return negative ? T(0 - x) : T(x);
+    }
+
+    // Reads the next non-whitespace character ('\0' at the end of the input)
+    char read_char() {
+        while (p < end && std::isspace((unsigned char)*p)) ++p;
+        return p < end ? *p++ : '\0';
+    }
+
+    // True once only whitespace is left
+    bool eof() {
+        while (p < end && std::isspace((unsigned char)*p)) ++p;
+        return p == end;
+    }
+
+private:
+    static constexpr uint64_t POW10[9] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+
+    static bool is_digit(char c) { return (unsigned)(c - '0') <= 9; }
+
+    // Number of leading ASCII digits in 8 bytes, first byte lowest
+    static int leading_digits(uint64_t chunk) {
+        if constexpr (std::endian::native != std::endian::little) {
+            int len = 0;
+            while (len < 8 && is_digit((char)(chunk >> (8 * len)))) ++len;
+            return len;
+        }
+        // Per byte, bit 7 is set iff it is below '0' (the subtraction wraps)
+        // or above '9' (adding 0x76 carries into bit 7). Borrows and carries
+        // only reach later bytes, past the first non-digit.
+        uint64_t x = chunk - 0x3030303030303030ULL;
+        uint64_t bad = (x | (x + 0x7676767676767676ULL)) & 0x8080808080808080ULL;
+        return bad ? std::countr_zero(bad) / 8 : 8;
+    }
+
+    // Value of 8 ASCII digits, first byte most significant (zero bytes in
+    // front act as leading zeros)
+    static uint64_t fold_digits(uint64_t chunk) {
+        if constexpr (std::endian::native != std::endian::little) {
+            uint64_t x = 0;
+            for (int i = 0; i < 8; ++i) x = x * 10 + ((chunk >> (8 * i)) & 0x0F);
+            return x;
+        }
+        chunk = (chunk & 0x0F0F0F0F0F0F0F0FULL) * 2561 >> 8;             // pairs
+        chunk = (chunk & 0x00FF00FF00FF00FFULL) * 6553601 >> 16;         // quads
+        return (chunk & 0x0000FFFF0000FFFFULL) * 42949672960001ULL >> 32; // all 8
+    }
+};
+
+struct FastOutput {
+    static constexpr int SIZE = 1 << 16;
+    FILE* f;
+    char buf[SIZE];
+    int len = 0;
+
+    FastOutput(FILE* out = stdout) : f(out) {}
+    ~FastOutput() { flush(); }
+
+    FastOutput(const FastOutput&) = delete;
+    FastOutput& operator=(const FastOutput&) = delete;
+
+    void flush() {
+        fwrite(buf, 1, len, f);
+        len = 0;
+    }
+
+    void write_char(char c) {
+        if (len == SIZE) flush();
+        buf[len++] = c;
+    }
+
+    // Writes an integer, followed by 'sep' unless it is '\0'
+    template<typename T>
+    void write(T value, char sep = '\n') {
+        if (len > SIZE - 24) flush(); // room for any 64-bit value and 'sep'
+        uint64_t x = value;
+        if constexpr (std::is_signed_v<T>) {
+            if (value < 0) {
+                buf[len++] = '-';
+                x = 0 - x;
+            }
+        }
+        char tmp[20];
+        int i = 20;
+        while (x >= 100) {
+            i -= 2;
+            std::memcpy(tmp + i, DIGIT_PAIRS + x % 100 * 2, 2);
+            x /= 100;
+        }
+        if (x >= 10) {
+            i -= 2;
+            std::memcpy(tmp + i, DIGIT_PAIRS + x * 2, 2);
+        } else {
+            tmp[--i] = char('0' + x);
+        }
+        std::memcpy(buf + len, tmp + i, 20 - i);
+        len += 20 - i;
+        if (sep) buf[len++] = sep;
+    }
+
+private:
+    static constexpr char DIGIT_PAIRS[201] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+};
+
+// --- Example Usage ---
+// int main() {
+//     FastInput in;
+//     FastOutput out;
+//     int n = in.read();
+//     long long sum = 0;
+//     for (int i = 0; i < n; ++i) sum += in.read<long long>();
+//     out.write(sum); // "<sum>\n"
+// }
+#endif // CODEBOOK_FAST_IO
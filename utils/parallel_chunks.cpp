@@ -0,0 +1,45 @@
+/**
+ * =================================================================
+ * Parallel Chunks (fork-join over an index range)
+ * =================================================================
+ *
+ * Description:
+ * `parallel_chunks(threads, count, grain, f)` splits [0, count) into
+ * contiguous chunks and runs `f(begin, end)` on each, one chunk per
+ * `std::thread`, the last one on the calling thread, and returns once
+ * all are done. Chunks get at least `grain` items, so small ranges run
+ * serially on the caller without spawning anything.
+ *
+ * Used for the data-parallel passes of the multi-core builds
+ * (segment_tree.cpp, lca_binary_lifting.cpp). No pool is kept: every
+ * call spawns, which is fine for the few large passes of a build but
+ * not for a hot loop.
+ *
+ */
+
+#ifndef CODEBOOK_PARALLEL_CHUNKS
+#define CODEBOOK_PARALLEL_CHUNKS
+#include <bits/stdc++.h>
+
+// Run f(begin, end) over [0, count) in contiguous chunks, one per thread,
+// the last one on the calling thread. Each thread gets at least 'grain' items.
+template <typename F>
+void parallel_chunks(int threads, int count, int grain, F&& f) {
+    threads = std::clamp(count / std::max(1, grain), 1, std::max(1, threads));
+    auto bound = [&](int i) { return (int)((long long)count * i / threads); };
+    std::vector<std::thread> pool;
+    for (int i = 0; i + 1 < threads; ++i) {
+        pool.emplace_back([&f, b = bound(i), e = bound(i + 1)] { f(b, e); });
+    }
+    f(bound(threads - 1), count);
+    for (auto& th : pool) th.join();
+}
+
+// --- Example Usage ---
+// int main() {
+//     std::vector<long long> squares(1 << 20);
+//     parallel_chunks(4, squares.size(), 1 << 14, [&](int b, int e) {
+//         for (int i = b; i < e; ++i) squares[i] = 1LL * i * i;
+//     });
+// }
+#endif // CODEBOOK_PARALLEL_CHUNKS
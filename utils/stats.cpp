@@ -0,0 +1,175 @@
+/**
+ * =================================================================
+ * Hot-Path Statistics (compile-time optional)
+ * =================================================================
+ *
+ * Description:
+ * Counters that show *why* an operation was slow: how long the DSU
+ * parent chains are, how many nodes a segment tree query or update
+ * visits, and how deep it recurses. Build with `-DCODEBOOK_STATS` to
+ * enable them; otherwise every hook expands to nothing and the
+ * instrumented code is exactly the uninstrumented one.
+ *
+ * - `dsu_stats`:     find_set calls, a log2 histogram of path lengths
+ * (before compression) and the longest one, union calls, real links.
+ * (dsu.cpp: `DSU`, `CompactDSU`)
+ * - `segtree_stats`: queries and updates, log2 histograms of the nodes
+ * each one visited, and the deepest recursion / climb seen.
+ * (segment_tree.cpp: `SegTree`, `IterSegTree`)
+ *
+ * Counters are relaxed atomics, so concurrent const queries stay safe;
+ * expect them to cost a few percent when enabled. `dump(os)` prints a
+ * report, `reset()` zeroes everything, e.g. once per traffic window.
+ *
+ * Hooks for instrumenting code:
+ * - `CODEBOOK_STATS_ONLY(statement;)`: kept only with CODEBOOK_STATS.
+ * - `StatsFrame`: one per visited node / recursion level, feeding the
+ * per-thread `stats_scope` of the operation in progress.
+ *
+ * Self-check: built directly, this file runs a few DSU and SegTree
+ * operations and asserts that the counters stay at zero in a default
+ * build and count with `-DCODEBOOK_STATS`. Build it both ways:
+ *   g++ -std=c++20 utils/stats.cpp && ./a.out
+ *   g++ -std=c++20 -DCODEBOOK_STATS utils/stats.cpp && ./a.out
+ *
+ */
+
+// Include guard instead of `#pragma once`: this file is also a main file.
+// Not named CODEBOOK_STATS: that is the feature flag tested below.
+#ifndef CODEBOOK_UTILS_STATS
+#define CODEBOOK_UTILS_STATS
+#include <bits/stdc++.h>
+
+#ifdef CODEBOOK_STATS
+#define CODEBOOK_STATS_ONLY(...) __VA_ARGS__
+#else
+#define CODEBOOK_STATS_ONLY(...)
+#endif
+
+// Counts of values in power-of-two buckets: 0, 1, [2, 3], [4, 7], ...
+struct StatsHistogram {
+    static constexpr int BUCKETS = 65;
+    std::atomic<uint64_t> bucket[BUCKETS] = {};
+    std::atomic<uint64_t> max{0};
+
+    void add(uint64_t x) {
+        bucket[std::bit_width(x)].fetch_add(1, std::memory_order_relaxed);
+        uint64_t seen = max.load(std::memory_order_relaxed);
+        while (x > seen && !max.compare_exchange_weak(seen, x, std::memory_order_relaxed)) {}
+    }
+
+    void reset() {
+        for (auto& b : bucket) b.store(0, std::memory_order_relaxed);
+        max.store(0, std::memory_order_relaxed);
+    }
+
+    void dump(std::ostream& os, const char* name) const {
+        os << "  " << name << " (max " << max.load(std::memory_order_relaxed) << "):\n";
+        for (int i = 0; i < BUCKETS; ++i) {
+            uint64_t count = bucket[i].load(std::memory_order_relaxed);
+            if (!count) continue;
+            uint64_t lo = i == 0 ? 0 : 1ULL << (i - 1), hi = i == 0 ? 0 : (lo << 1) - 1;
+            os << "    [" << lo << ", " << hi << "]: " << count << "\n";
+        }
+    }
+};
+
+struct DSUStats {
+    std::atomic<uint64_t> finds{0}, unions{0}, links{0};
+    StatsHistogram path; // parent hops from the queried node to its root
+
+    void reset() {
+        finds = unions = links = 0;
+        path.reset();
+    }
+
+    void dump(std::ostream& os = std::cerr) const {
+        os << "DSU: " << finds << " finds, " << unions << " unions (" << links << " linked)\n";
+        path.dump(os, "find path length");
+    }
+};
+
+struct SegTreeStats {
+    std::atomic<uint64_t> queries{0}, updates{0};
+    StatsHistogram query_nodes, update_nodes; // nodes visited per operation
+    StatsHistogram depth;                     // deepest level reached per operation
+
+    void reset() {
+        queries = updates = 0;
+        query_nodes.reset();
+        update_nodes.reset();
+        depth.reset();
+    }
+
+    void dump(std::ostream& os = std::cerr) const {
+        os << "SegTree: " << queries << " queries, " << updates << " updates\n";
+        query_nodes.dump(os, "nodes per query");
+        update_nodes.dump(os, "nodes per update");
+        depth.dump(os, "max depth per operation");
+    }
+};
+
+inline DSUStats dsu_stats;
+inline SegTreeStats segtree_stats;
+
+inline void stats_bump(std::atomic<uint64_t>& counter, uint64_t by = 1) {
+    counter.fetch_add(by, std::memory_order_relaxed);
+}
+
+// The operation in progress on this thread
+struct StatsScope {
+    uint64_t nodes = 0;
+    int depth = 0, max_depth = 0;
+};
+inline thread_local StatsScope stats_scope;
+
+// Marks one visited node, one level below the enclosing frame
+struct StatsFrame {
+    StatsFrame() {
+        stats_scope.nodes++;
+        stats_scope.max_depth = std::max(stats_scope.max_depth, ++stats_scope.depth);
+    }
+    ~StatsFrame() { stats_scope.depth--; }
+};
+
+// Record the finished operation of this thread into 'nodes' and 'segtree_stats.depth'
+inline void stats_finish(StatsHistogram& nodes) {
+    nodes.add(stats_scope.nodes);
+    segtree_stats.depth.add(stats_scope.max_depth);
+    stats_scope = StatsScope{};
+}
+
+// --- Example Usage ---
+// Compiled only when this file is built directly, so other files can include it.
+#if __INCLUDE_LEVEL__ == 0
+#include "../data_structures/dsu.cpp"
+#include "../data_structures/segment_tree.cpp"
+
+int main() {
+    DSU dsu(1 << 10);
+    for (int i = 1; i < (1 << 10); ++i) dsu.union_sets(i - 1, i);
+    std::vector<long long> a(1 << 10, 1);
+    SegTree st(a);
+    IterSegTree it(a);
+    for (int i = 0; i < 100; ++i) {
+        st.update(i, 2);
+        it.update(i, 2);
+        assert(st.query(i, 1000) == it.query(i, 1000));
+    }
+
+    bool counted = dsu_stats.finds > 0 && dsu_stats.unions > 0 && segtree_stats.queries > 0 &&
+                   segtree_stats.updates > 0;
+#ifdef CODEBOOK_STATS
+    assert(counted); // the hooks are compiled in
+    dsu_stats.dump();
+    segtree_stats.dump();
+    dsu_stats.reset();
+    assert(dsu_stats.finds == 0);
+#else
+    assert(!counted && segtree_stats.depth.max == 0); // every hook compiled to nothing
+#endif
+    std::cout << (counted ? "stats enabled" : "stats disabled") << std::endl;
+    return 0;
+}
+#endif
+#endif // CODEBOOK_UTILS_STATS